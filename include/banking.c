@@ -483,6 +483,197 @@ int bnk_io_read(char fnum, char cr, char * data, int num)
 		return -1;	
 }
 
+// Streaming writer: encodes banked memory through a small buffer in common RAM and flushes it with block writes
+char bnk_stream_buf[BNK_STREAM_BUFSIZE];
+char bnk_stream_pos;
+char bnk_stream_error;
+char bnk_stream_device;
+unsigned bnk_stream_count;
+void (*bnk_stream_progress)(unsigned count);
+
+bool bnk_stream_open(char device, const char *fname)
+// Open a file for streaming write, fname should include type and mode (e.g. name,p,w)
+{
+	bnk_stream_pos = 0;
+	bnk_stream_error = 0;
+	bnk_stream_count = 0;
+	bnk_stream_device = device;
+	krnio_setbnk(0, 0);
+	krnio_setnam(fname);
+	return krnio_open(BNK_STREAM_FNUM, device, 2);
+}
+
+bool bnk_stream_flush()
+// Write the buffer to the file and report the number of bytes written
+{
+	if (bnk_stream_pos && !bnk_stream_error)
+	{
+		if (krnio_write(BNK_STREAM_FNUM, bnk_stream_buf, bnk_stream_pos) != bnk_stream_pos)
+		{
+			bnk_stream_error = 1;
+		}
+		bnk_stream_count += bnk_stream_pos;
+		if (bnk_stream_progress)
+		{
+			bnk_stream_progress(bnk_stream_count);
+		}
+	}
+	bnk_stream_pos = 0;
+	return !bnk_stream_error;
+}
+
+void bnk_stream_putb(char b)
+// Add a byte to the stream
+{
+	bnk_stream_buf[bnk_stream_pos++] = b;
+	if (bnk_stream_pos == BNK_STREAM_BUFSIZE)
+	{
+		bnk_stream_flush();
+	}
+}
+
+bool bnk_stream_write(char cr, volatile char *sp, unsigned size)
+// Add size bytes from the source bank/address to the stream unencoded
+{
+	char old = mmu.cr;
+	while (size > 0)
+	{
+		mmu.cr = cr;
+		char c = *sp++;
+		mmu.cr = old;
+		bnk_stream_putb(c);
+		size--;
+	}
+	return !bnk_stream_error;
+}
+
+bool bnk_stream_rle(char cr, volatile char *sp, unsigned size)
+// Add size bytes from the source bank/address to the stream run length encoded
+// Runs of 3 to 129 equal bytes: count + 126 and the byte, literals of 1 to 128 bytes: count - 1 and the bytes
+{
+	unsigned i = 0;
+	unsigned litstart = 0;
+	unsigned run;
+	char litcount = 0;
+	char b;
+
+	while (i < size)
+	{
+		b = bnk_readb(cr, sp + i);
+		run = 1;
+		while (i + run < size && run < 129 && bnk_readb(cr, sp + i + run) == b)
+		{
+			run++;
+		}
+
+		if (run > 2)
+		{
+			if (litcount)
+			{
+				bnk_stream_putb(litcount - 1);
+				bnk_stream_write(cr, sp + litstart, litcount);
+				litcount = 0;
+			}
+			bnk_stream_putb(run + 126);
+			bnk_stream_putb(b);
+			i += run;
+		}
+		else
+		{
+			if (!litcount)
+			{
+				litstart = i;
+			}
+			litcount++;
+			i++;
+			if (litcount == 128)
+			{
+				bnk_stream_putb(litcount - 1);
+				bnk_stream_write(cr, sp + litstart, litcount);
+				litcount = 0;
+			}
+		}
+	}
+	if (litcount)
+	{
+		bnk_stream_putb(litcount - 1);
+		bnk_stream_write(cr, sp + litstart, litcount);
+	}
+	return !bnk_stream_error;
+}
+
+bool bnk_stream_close()
+// Flush the remaining buffer, close the file and read the drive status from the command channel
+// DOS errors such as disk full or write protect only show there, codes from 20 up fail
+{
+	char status[2];
+
+	bnk_stream_flush();
+	krnio_close(BNK_STREAM_FNUM);
+
+	krnio_setbnk(0, 0);
+	krnio_setnam("");
+	if (!krnio_open(15, bnk_stream_device, 15))
+	{
+		krnio_close(15);
+		return 0;
+	}
+	if (krnio_read(15, status, 2) != 2 || status[0] < '0' || status[0] >= '2')
+	{
+		bnk_stream_error = 1;
+	}
+	krnio_close(15);
+	return !bnk_stream_error;
+}
+
+unsigned bnk_io_read_rle(char fnum, char cr, char *data, unsigned size)
+// Read and decode a run length encoded stream from an open file to the specified bank
+// Returns the number of bytes decoded
+{
+	char old = mmu.cr;
+	unsigned i = 0;
+	char ctrl, b, n;
+
+	if (!krnio_chkin(fnum))
+	{
+		return 0;
+	}
+
+	while (i < size && !krnio_status())
+	{
+		ctrl = krnio_chrin();
+		if (ctrl & 0x80)
+		{
+			// Run of ctrl - 126 times the next byte
+			n = ctrl - 126;
+			b = krnio_chrin();
+			mmu.cr = cr;
+			while (n && i < size)
+			{
+				data[i++] = b;
+				n--;
+			}
+			mmu.cr = old;
+		}
+		else
+		{
+			// Literal of ctrl + 1 bytes
+			n = ctrl + 1;
+			while (n && i < size)
+			{
+				b = krnio_chrin();
+				mmu.cr = cr;
+				data[i++] = b;
+				mmu.cr = old;
+				n--;
+			}
+		}
+	}
+	krnio_pstatus[fnum] = krnio_status();
+	krnio_clrchn();
+	return i;
+}
+
 bool bnk_iec_active(char device)
 // Return if device is active at specified IEC ID
 {
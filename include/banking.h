@@ -83,6 +83,10 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 #define SCROLL_DOWN 0x04
 #define SCROLL_UP 0x08
 
+// Defines for the streaming writer
+#define BNK_STREAM_BUFSIZE 64  // Size of the stream buffer in common RAM
+#define BNK_STREAM_FNUM 1      // Logical file number used for streaming
+
 // Kernal defines for IEC statis detection
 #define STATUS 0x90          // Kernal I/O completion status
 #define SECOND 0xFF93
@@ -112,6 +116,13 @@ __noinline void bnk_redef_charset(unsigned vdcdest, char scr, volatile char *sp,
 __noinline bool bnk_load(char device, char bank, const char *start, const char *fname);
 __noinline bool bnk_save(char device, char bank, const char *start, const char *end, const char *fname);
 __noinline int bnk_io_read(char fnum, char cr, char * data, int num);
+__noinline bool bnk_stream_open(char device, const char *fname);
+__noinline bool bnk_stream_flush();
+__noinline void bnk_stream_putb(char b);
+__noinline bool bnk_stream_write(char cr, volatile char *sp, unsigned size);
+__noinline bool bnk_stream_rle(char cr, volatile char *sp, unsigned size);
+__noinline bool bnk_stream_close();
+__noinline unsigned bnk_io_read_rle(char fnum, char cr, char *data, unsigned size);
 __noinline bool bnk_iec_active(char device);
 __noinline void sid_startmusic();
 __noinline void sid_stopmusic();
@@ -120,6 +131,8 @@ __noinline void sid_pausemusic();
 
 // Global variables
 extern char bootdevice;
+extern unsigned bnk_stream_count;
+extern void (*bnk_stream_progress)(unsigned count);
 
 #include "filebrowse.h"
 
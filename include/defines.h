@@ -5,6 +5,10 @@
 #define MACOSTART 0x1300 // Start of machine code area
 #define MACOSIZE 0x0800  // Length of machine code area
 
+/* Kernal keyboard buffer */
+#define KEYBUFFERCOUNT 0x00D0 // Number of keys waiting
+#define KEYBUFFER 0x034A      // Keys waiting, first key to be read first
+
 /* Bank 0 save data adress mapping */
 #define OVERLAYBANK0 0xC000 // Start address overlay storage bank 0
 
@@ -27,7 +31,32 @@
 #define SCREENMAP_SIGNATURE_BYTES 48UL
 #define SCREENMAP_DATA_BYTES(width, height) ((unsigned long)(width) * (unsigned long)(height))
 #define SCREENMAP_STORAGE_BYTES(width, height) ((SCREENMAP_DATA_BYTES((width), (height)) * 2UL) + SCREENMAP_SIGNATURE_BYTES)
-#define UNDO_BUFFER_BYTES(width, height, redoroompresent) (SCREENMAP_DATA_BYTES((width), (height)) * (2UL + (2UL * (unsigned long)(redoroompresent))))
+#define SCREENMAP_MONO_STORAGE_BYTES(width, height) (SCREENMAP_DATA_BYTES((width), (height)) + SCREENMAP_SIGNATURE_BYTES)
+
+// Editor only: number of planes and storage size depending on mono flag of the canvas
+#define SCREENMAP_PLANES (canvasmono ? 1UL : 2UL)
+#define SCREENMAP_CANVAS_BYTES(width, height) (canvasmono ? SCREENMAP_MONO_STORAGE_BYTES((width), (height)) : SCREENMAP_STORAGE_BYTES((width), (height)))
+#define UNDO_BUFFER_BYTES(width, height) (SCREENMAP_DATA_BYTES((width), (height)) * SCREENMAP_PLANES)
+
+// Compressed screen map file: magic, format and unpacked size (little-endian) before the encoded data
+#define SCREENMAP_RLE_MAGIC0 0x56 // 'V', legacy files start with the low byte of the load address (0x00)
+#define SCREENMAP_RLE_MAGIC1 0x43 // 'C'
+#define SCREENMAP_RLE_FORMAT 0x01 // Run length encoded
+#define SCREENMAP_RLE_HEADER 5
+#define SCREENMAP_ROWS_FORMAT 0x02 // Rows of screencodes and attributes, width, height and planes in header
+#define SCREENMAP_ROWS_HEADER 8
+
+// Save formats of screen maps
+#define SAVEFORMAT_RAW 0  // Legacy layout as in memory
+#define SAVEFORMAT_RLE 1  // Run length encoded
+#define SAVEFORMAT_ROWS 2 // Row format for partial loading
+
+// Undo history file: magic, format, canvas width and height, planes and entry count (little-endian)
+#define UNDO_FILE_MAGIC0 0x56 // 'V'
+#define UNDO_FILE_MAGIC1 0x55 // 'U'
+#define UNDO_FILE_FORMAT 0x01
+#define UNDO_FILE_HEADER 10
+#define UNDO_FILE_ENTRY 11 // Per entry: ystart, xstart, height, width, type and data size
 
 struct OverlayStruct
 {
@@ -40,19 +69,117 @@ extern char overlay_active;
 // Undo data
 extern char undoenabled;
 extern unsigned undoaddress;
-extern char undonumber;
-extern char undo_undopossible;
-extern char undo_redopossible;
+extern unsigned undo_undopossible;
+extern unsigned undo_redopossible;
 struct UndoStruct
 {
-    unsigned address;
+    unsigned prev;
+    unsigned next;
     unsigned ystart;
     unsigned xstart;
     unsigned height;
     unsigned width;
     char redopresent;
+    char delta;
+    unsigned size;
+    unsigned redoaddress;
+};
+#define UNDO_HEADER sizeof(struct UndoStruct) // Header in VDC memory before the data of each undo entry
+#define UNDO_NEXT 2                           // Offset of the next field in the header
+#define UNDO_CHARSET 2                        // Value of delta for an entry holding a replaced charset
+#define UNDO_CHARSET_BYTES 2048               // Bytes of a charset entry
+#define UNDO_MOVE 3                           // Value of delta for a move mode shift
+#define UNDO_MOVE_PARAMS 6                    // Bytes of shift parameters before the strips of a move entry
+#define UNDO_RESIZE 4                         // Value of delta for a canvas resize
+#define UNDO_RESIZE_PARAMS 4                  // Bytes of new width and height before the cut off cells
+extern unsigned undo_tail;
+extern unsigned undo_current;
+extern struct UndoStruct undo_entry;
+extern unsigned undostart;
+extern unsigned long undoend;
+extern char undo_banked;
+extern char undo_pending;
+extern char undo_screendirty;
+extern char undoload_pending;
+extern unsigned undoload_count;
+
+// Undo memory diagnostics, found at the undo_stats label by the VICE test harness
+struct UndoStatsStruct
+{
+    unsigned used;       // Bytes from the oldest entry to the write head
+    unsigned free;       // Bytes of the undo area not in use
+    unsigned entries;    // Undo and redo entries in the log
+    unsigned largest;    // Largest entry including header since the last clear
+    unsigned evictions;  // Entries dropped for room since the last clear
+    unsigned redofailed; // Undos without room for a redo image since the last clear
+};
+extern struct UndoStatsStruct undo_stats;
+#define UNDO_CHUNK 80 // Bytes read at once when encoding undo deltas
+extern char undo_before[UNDO_CHUNK];
+#define UNDO_GROUP_MAX 80 // Cells logged in one undo group
+extern char undo_groupcount;
+
+// Character editor glyph history
+#define CHARUNDO_MAX 32 // Glyph edits kept in the history
+struct CharUndoStruct
+{
+    char stdoralt;
+    char screencode;
+    char delta[8];
+};
+extern struct CharUndoStruct charundo[CHARUNDO_MAX];
+extern char charundo_newest;
+extern char charundo_undopossible;
+extern char charundo_redopossible;
+
+// Multiple screens per project
+#define SCREENS_MAX 9 // Maximum number of screens in a project
+extern char screencount;
+extern char screencurrent;
+
+// Partial loading of row format screen files
+extern char screenload_pending;
+extern char screenload_planes;
+extern unsigned screenload_next;
+extern unsigned screenload_width;
+extern unsigned screenload_height;
+
+// Layers
+#define LAYER_ROWMAX 80 // Maximum row part composited at once
+extern char layershow;
+extern unsigned layerhidden;
+extern char layertransparent;
+
+// Hardware scrolled canvas
+#define HWSCROLL_SKIP 32         // Columns of the canvas strip right of the screen
+#define HWSCROLL_MARGIN 16       // Rows of the canvas strip below the screen
+#define HWSCROLL_MINSPARE 0x4000 // VDC memory to keep free above the strip for screens and undo
+#define HWSCROLL_FINESTEP 2      // Pixels per frame of the fine scroll glide, divides 8
+#define SCROLL_JUMP_MIN 3        // Scroll positions from which a cursor move redraws the view once
+#define MINIMAP_MAXW 78          // Maximum width of the canvas overview in cells
+#define MINIMAP_CHUNK 64         // Screen map bytes copied from Bank 1 at a time for the overview
+#define MINIMAP_X 1              // Screen column of the first overview cell
+#define MINIMAP_Y 2              // Screen row of the first overview cell
+#define ZOOM_GLYPHS 16           // Quarter block glyphs generated in the alternate charset for the zoomed out view
+#define ZOOM_MAXW 80             // Maximum screen width of the zoomed out view
+#define ZOOM_STEP 16             // Canvas cells the zoomed out view scrolls past the cursor, even
+extern char hwscroll;
+extern char hwscroll_x;
+extern char hwscroll_y;
+#define SPLIT_ROWS (vdc_state.height / 2) // Rows of the edited pane in split view, a divider row and the reference pane follow
+extern char splitview;
+extern struct VDCViewport refview;
+extern char cursor_cached;
+
+// Area of the screen map changed since a view was last brought up to date
+struct DirtyRect
+{
+    char dirty;
+    unsigned minrow;
+    unsigned maxrow;
+    unsigned mincol;
+    unsigned maxcol;
 };
-extern struct UndoStruct Undo[41];
 
 // Importer data
 struct IMPORTVARS
@@ -86,6 +213,7 @@ extern char charsetchanged[2];
 extern char appexit;
 extern char targetdevice;
 extern char filename[21];
+extern char saveformat;
 extern char programmode[11];
 extern char showbar;
 
@@ -93,6 +221,8 @@ extern unsigned screen_col;
 extern unsigned screen_row;
 extern unsigned screentotal;
 extern char screenbackground;
+extern char canvasmono;
+extern char monocolor;
 extern char plotscreencode;
 extern char plotcolor;
 extern char plotreverse;
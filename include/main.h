@@ -11,30 +11,77 @@ void initoverlay();
 void loadoverlay(char overlay_select);
 char *screenmap_screenaddr(unsigned row, unsigned col, unsigned width);
 char *screenmap_attraddr(unsigned row, unsigned col, unsigned width, unsigned height);
+void screenmap_rowmove(char *dest, char *src, unsigned width);
+char screenmap_readattr(unsigned row, unsigned col);
+void canvas_sync();
+void split_sync();
+void screenmap_dirty(unsigned row, unsigned col, unsigned width, unsigned height);
+void split_redraw();
 void screenmapplot(char row, char col, char screencode, char attribute);
 void placesignature();
 void screenmapfill(char screencode, char attribute);
+char screenload_rows(unsigned upto);
+void screenload_finish();
+char screenload_idlekey(char key);
+void hwscroll_setstart(char display);
+void hwscroll_init();
+void hwscroll_exit();
+void hwscroll_glide(char direction);
+void canvas_scroll(char direction);
 void cursormove(char left, char right, char up, char down);
+void charundo_clear();
+void undostore_get(char cr, char *dp, unsigned address, unsigned size);
+void undo_readheader(unsigned address);
+void undo_stats_update();
+void undo_commit();
+void undo_group_close();
+void undo_group_cell(unsigned row, unsigned col);
 void undo_new(unsigned row, unsigned col, unsigned width, unsigned height);
-void undo_performundo();
+void undo_charset(char stdoralt);
+void undo_move(unsigned row, unsigned col, unsigned width, unsigned height, signed char *params);
 void undo_escapeundo();
-void undo_performredo();
+void undo_clear();
+void undoload_finish();
+unsigned screens_slotaddress(char screen);
+char screens_maxcount();
+char screens_single();
+void screens_store();
+void screens_fetch(char screen);
+void updatecanvas_title();
+void screens_switch(char screen);
+void layers_readrow(char screen, unsigned row, unsigned col, char width);
+void layers_row(unsigned row, unsigned col, char width);
+void layers_plotcell(char x, char y, char screencode, char attribute);
+void layers_composite(struct VDCViewport *vp);
+void layers_update();
+char layers_flatten();
 void helpscreen_load(char screennumber);
 void loadsyscharset();
 void restorealtcharset();
+void cursor_cache();
 void plotcursor();
 void hidecursor();
 void resetcursor();
 void plotmove(char direction);
+unsigned canvas_offsetfor(unsigned pos, unsigned offset, char max);
+void canvas_viewto(unsigned xoffset, unsigned yoffset, unsigned x, unsigned y);
+char plotmove_nextkey();
+void plotmove_repeat(char key);
+void canvas_navigate(char key);
 void change_plotcolor(char newval);
 char getmaxy();
 char getmaxx();
+char *statusbar_digits(char *s, unsigned value, char width);
 void printstatusbar();
 void initstatusbar();
 void hidestatusbar();
 void togglestatusbar();
 void showchareditfield(char stdoralt);
 void updatecanvas();
+void canvas_resize(unsigned newwidth, unsigned newheight);
+void undo_resize(unsigned newwidth, unsigned newheight);
+void undo_performundo();
+void undo_performredo();
 signed chooseidandfilename(const char *headertext, char maxlen);
 char checkiffileexists(char *filetocheck, unsigned char id);
 char import_dialogue(char mode, const char *message);
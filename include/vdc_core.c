@@ -177,7 +177,7 @@ void vdc_set_multab()
     for (char index = 0; index < vdc_state.height; index++)
     {
         multab[index] = val;
-        val += vdc_state.width + vdc_state.disp_skip;
+        val += VDC_ROWSTRIDE;
     }
 }
 
@@ -188,9 +188,13 @@ char vdc_set_mode(char mode)
     unsigned val;
 
     // Check if extended memory is required and available. If not, return with code 0.
+    // Exception is mono mode if text, attributes and charsets fit in 16 KB: the attribute area then doubles as swap.
     if (vdc_modes[mode].extmem && vdc_state.memsize == 16)
     {
-        return 0;
+        if (!vdc_state.mono || vdc_modes[mode].base_attr + (vdc_modes[mode].width * vdc_modes[mode].height) > vdc_modes[mode].char_std || vdc_modes[mode].char_alt + 0x1000 > 0x4000)
+        {
+            return 0;
+        }
     }
 
     // Set screen state
@@ -208,12 +212,21 @@ char vdc_set_mode(char mode)
     vdc_state.dispaddr_offset = 0;
     vdc_state.disp_skip = 0;
 
+    // Mono mode on 16 KB VDC: no swap and extended memory above the charsets
+    if (vdc_modes[mode].extmem && vdc_state.memsize == 16)
+    {
+        vdc_state.swap_text = vdc_state.base_attr;
+        vdc_state.swap_attr = vdc_state.base_attr;
+        vdc_state.extended = 0x4000;
+    }
+
     // Set multiplication table for screen width
     vdc_set_multab();
 
     // Set VDC addresses
     vdc_disable_display();
     vdc_set_disp_address(vdc_modes[mode].base_text, vdc_modes[mode].base_attr);
+    vdc_reg_write(VDCR_ROWINC, 0);
     vdc_set_charset_address(vdc_modes[mode].char_std);
     vdc_restore_charsets();
 
@@ -224,7 +237,7 @@ char vdc_set_mode(char mode)
     } while (vdc_modes[mode].regset[index] != 255);
 
     // Check if extended memory is required and not yet set. If so, set.
-    if (vdc_modes[mode].extmem && !vdc_state.memextended)
+    if (vdc_modes[mode].extmem && !vdc_state.memextended && vdc_state.memsize == 64)
     {
         vdc_set_extended_memsize();
     }
@@ -385,8 +398,8 @@ void vdc_scroll_copy(unsigned dest, unsigned src, char lines, char length)
     for (char line = 0; line < lines; line++)
     {
         vdc_block_copy_page(dest, src, length);
-        src += vdc_state.width;
-        dest += vdc_state.width;
+        src += VDC_ROWSTRIDE;
+        dest += VDC_ROWSTRIDE;
     }
 }
 
@@ -93,6 +93,9 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 #define VDC_A_REVERSE 64
 #define VDC_A_ALTCHAR 128
 
+// VDC memory row stride: screen width plus the columns skipped by the row increment
+#define VDC_ROWSTRIDE (vdc_state.width + vdc_state.disp_skip)
+
 // Character codes
 #define C_SPACE 0x20
 #define C_ARROW 0x5B
@@ -180,6 +183,7 @@ struct VDCStatus
     unsigned extended;
     unsigned dispaddr_offset;
     char disp_skip;
+    char mono;
 };
 extern struct VDCStatus vdc_state;
 extern char linebuffer[81];
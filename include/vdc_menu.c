@@ -80,18 +80,21 @@ struct VDCMenuBar menubar = {
     {0, 0, 0, 0, 0},
     0};
 
-char pulldown_options[VDC_PULLDOWN_NUMBER] = {6, 4, 5, 5, 2, 6, 3, 2};
+char pulldown_options[VDC_PULLDOWN_NUMBER] = {7, 6, 5, 5, 2, 6, 3, 2, 6};
 char pulldown_titles[VDC_PULLDOWN_NUMBER][VDC_PULLDOWN_MAXOPTIONS][VDC_PULLDOWN_MAXLENGTH] = {
     {"Width:      80 ",
      "Height:     25 ",
      "Background:  0 ",
      "Screenmode:  0 ",
      "Clear          ",
-     "Fill           "},
+     "Fill           ",
+     "Colour:  Full  "},
     {"Save screen    ",
      "Load screen    ",
      "Save project   ",
-     "Load project   "},
+     "Load project   ",
+     "Screen: 1 of 1 ",
+     "Format:    Raw "},
     {"Load standard  ",
      "Load alternate ",
      "Save standard  ",
@@ -114,7 +117,13 @@ char pulldown_titles[VDC_PULLDOWN_NUMBER][VDC_PULLDOWN_MAXOPTIONS][VDC_PULLDOWN_
      "Only chars",
      "Only color"},
     {"Yes",
-     "No "}};
+     "No "},
+    {"Add empty   ",
+     "Duplicate   ",
+     "Delete      ",
+     "Layers:  Off",
+     "Visible: Yes",
+     "Transp.: $20"}};
 
 // Menucolors
 char mc_mb_normal = VDC_LGREEN + VDC_A_REVERSE + VDC_A_ALTCHAR;
@@ -78,8 +78,8 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 // Set these for menubar and pulldown menu dimensions
 #define VDC_MENUBAR_MAXOPTIONS 5  // Number of options in main menu bar
 #define VDC_MENUBAR_MAXLENGTH 12  // Maxiumum length of main menu bar option names
-#define VDC_PULLDOWN_NUMBER 8     // Number of pull down menus defined
-#define VDC_PULLDOWN_MAXOPTIONS 6 // Maximum number of options for pull down meus
+#define VDC_PULLDOWN_NUMBER 9     // Number of pull down menus defined
+#define VDC_PULLDOWN_MAXOPTIONS 7 // Maximum number of options for pull down meus
 #define VDC_PULLDOWN_MAXLENGTH 17 // Maximum length of pull down menu option names
 
 // Set default colours and styles to use
@@ -101,6 +101,7 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
   #define VDC_POPUP_BORDER     0
 #endif
 #define VDC_MENU_YESNO 7                                                 // Number for Yes No pull down menu
+#define VDC_MENU_SCREENS 8                                               // Number for screens management pull down menu
 
 // Function prototypes
 void menu_placeheader(const char *header);
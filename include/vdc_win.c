@@ -84,7 +84,7 @@ struct WinStyleStruct winStyles[2] =
 		{VDC_LYELLOW, 0x70, 0x6e, 0x6d, 0x7d, 0x40, 0x40, 0x5d, 0x5d}};
 
 static inline void copy_fwd(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
-// Copy of a line direct from VDC source to VDC destination (for vertical based copy)
+// Copy of a line direct from VDC source to VDC destination (for vertical based copy and leftward copy in place)
 {
 	// Screen copy
 	vdc_block_copy(sdp, ssp, n);
@@ -92,20 +92,16 @@ static inline void copy_fwd(unsigned sdp, const unsigned ssp, unsigned cdp, cons
 	vdc_block_copy(cdp, csp, n);
 }
 
-static inline void copy_bwd(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
-// Copy of a line from VDC source via swap memory to VDC destination (for horizontal based copy)
+static inline void copy_right(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
+// Copy of a line to a higher VDC address in place (for rightward horizontal copy)
+// The block copy runs forward, so the line is copied from the right in chunks of at most the shift distance.
+// Shifts needing more chunks, such as the single column of a pan, bounce the line through swap memory,
+// or stage it in linebuffer where swap memory is missing or is the attribute area of the mode.
 {
-	// Check if swap memory is available given screenmode and VDC memory size
-	if (!vdc_state.memextended && vdc_state.swap_text > 0x3ff)
-	{
-		// Screen copy via bank 0 linebuffer
-		bnk_cpyfromvdc(BNK_DEFAULT, linebuffer, ssp, n);
-		bnk_cpytovdc(sdp, BNK_DEFAULT, linebuffer, n);
-		// Color copy via bank 0 linebuffer
-		bnk_cpyfromvdc(BNK_DEFAULT, linebuffer, csp, n);
-		bnk_cpytovdc(cdp, BNK_DEFAULT, linebuffer, n);
-	}
-	else
+	char by = sdp - ssp;
+	char chunk;
+
+	if (n > (unsigned)by * WIN_SHIFT_CHUNKS && (vdc_state.memextended || vdc_state.swap_text <= 0x3ff) && vdc_state.swap_text != vdc_state.base_attr)
 	{
 		// Screen copy via swap VDC memory
 		vdc_block_copy(vdc_state.swap_text, ssp, n);
@@ -113,6 +109,29 @@ static inline void copy_bwd(unsigned sdp, const unsigned ssp, unsigned cdp, cons
 		// Color copy via swap VDC memory
 		vdc_block_copy(vdc_state.swap_text, csp, n);
 		vdc_block_copy(cdp, vdc_state.swap_text, n);
+		return;
+	}
+
+	if (n > (unsigned)by * WIN_SHIFT_CHUNKS)
+	{
+		// Lines are at most the screen width, which fits linebuffer
+		// Screen copy
+		bnk_cpyfromvdc(BNK_DEFAULT, linebuffer, ssp, n);
+		bnk_cpytovdc(sdp, BNK_DEFAULT, linebuffer, n);
+		// Color copy
+		bnk_cpyfromvdc(BNK_DEFAULT, linebuffer, csp, n);
+		bnk_cpytovdc(cdp, BNK_DEFAULT, linebuffer, n);
+		return;
+	}
+
+	while (n)
+	{
+		chunk = (n > by) ? by : n;
+		n -= chunk;
+		// Screen copy
+		vdc_block_copy(sdp + n, ssp + n, chunk);
+		// Color copy
+		vdc_block_copy(cdp + n, csp + n, chunk);
 	}
 }
 
@@ -283,7 +302,7 @@ void vdcwin_read_string(struct VDCWin *win, char *buffer)
 		{
 			buffer[i++] = s2p(vdc_mem_read_at(sp + x));
 		}
-		sp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
 	}
 	while (i > 0 && buffer[i - 1] == ' ')
 		i--;
@@ -307,7 +326,7 @@ void vdcwin_write_string(struct VDCWin *win, const char *buffer)
 			else
 				vdc_mem_write_at(dp + x, ' ');
 		}
-		dp += vdc_state.width;
+		dp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -545,8 +564,8 @@ void vdcwin_put_rect_raw(struct VDCWin *win, char x, char y, char w, char h, cha
 		bnk_cpytovdc(sp, cr, chars, w);
 		vdc_block_fill(cp, vdc_state.text_attr, w);
 		chars += w;
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -570,8 +589,8 @@ void vdcwin_put_rect(struct VDCWin *win, char x, char y, char w, char h, char cr
 		}
 
 		chars += w;
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -588,7 +607,7 @@ void vdcwin_get_rect_raw(struct VDCWin *win, char x, char y, char w, char h, cha
 	{
 		bnk_cpyfromvdc(cr, chars, sp, w);
 		chars += w;
-		sp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -610,7 +629,7 @@ void vdcwin_get_rect(struct VDCWin *win, char x, char y, char w, char h, char cr
 		}
 
 		chars += w;
-		sp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -626,12 +645,12 @@ void vdcwin_insert_char(struct VDCWin *win)
 
 	while (y > win->cy)
 	{
-		copy_bwd(sp + 1, sp, cp + 1, cp, rx);
+		copy_right(sp + 1, sp, cp + 1, cp, rx);
 
-		sp -= vdc_state.width;
-		cp -= vdc_state.width;
-		vdc_mem_write_at(sp + vdc_state.width, vdc_mem_read_at(sp + rx));
-		vdc_mem_write_at(cp + vdc_state.width, vdc_mem_read_at(cp + rx));
+		sp -= VDC_ROWSTRIDE;
+		cp -= VDC_ROWSTRIDE;
+		vdc_mem_write_at(sp + VDC_ROWSTRIDE, vdc_mem_read_at(sp + rx));
+		vdc_mem_write_at(cp + VDC_ROWSTRIDE, vdc_mem_read_at(cp + rx));
 		y--;
 	}
 
@@ -641,7 +660,7 @@ void vdcwin_insert_char(struct VDCWin *win)
 
 	if (rx)
 	{
-		copy_bwd(sp + 1, sp, cp + 1, cp, rx);
+		copy_right(sp + 1, sp, cp + 1, cp, rx);
 	}
 
 	vdc_mem_write_at(sp, ' ');
@@ -660,11 +679,11 @@ void vdcwin_delete_char(struct VDCWin *win)
 	char y = win->cy + 1;
 	while (y < win->wy)
 	{
-		vdc_mem_write_at(sp + rx, vdc_mem_read_at(sp + vdc_state.width));
-		vdc_mem_write_at(cp + rx, vdc_mem_read_at(cp + vdc_state.width));
+		vdc_mem_write_at(sp + rx, vdc_mem_read_at(sp + VDC_ROWSTRIDE));
+		vdc_mem_write_at(cp + rx, vdc_mem_read_at(cp + VDC_ROWSTRIDE));
 
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 
 		copy_fwd(sp, sp + 1, cp, cp + 1, rx);
 
@@ -790,9 +809,9 @@ void vdcwin_scroll_left(struct VDCWin *win, char by)
 		//{
 		//	vdc_wait_no_vblank();
 		//}
-		copy_bwd(sp, sp + by, cp, cp + by, rx);
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		copy_fwd(sp, sp + by, cp, cp + by, rx);
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 	}
 	vdc_wait_no_vblank();
 }
@@ -807,9 +826,9 @@ void vdcwin_scroll_right(struct VDCWin *win, char by)
 
 	for (char y = 0; y < win->wy; y++)
 	{
-		copy_bwd(sp + by, sp, cp + by, cp, rx);
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		copy_right(sp + by, sp, cp + by, cp, rx);
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 	}
 }
 
@@ -820,30 +839,30 @@ void vdcwin_scroll_up(struct VDCWin *win, char by)
 	unsigned cp = win->cp;
 
 	char rx = win->wx;
-	int dst = vdc_state.width * by;
+	int dst = VDC_ROWSTRIDE * by;
 
 	for (char y = 0; y < win->wy - by; y++)
 	{
 		copy_fwd(sp, sp + dst, cp, cp + dst, rx);
-		sp += vdc_state.width;
-		cp += vdc_state.width;
+		sp += VDC_ROWSTRIDE;
+		cp += VDC_ROWSTRIDE;
 	}
 }
 
 void vdcwin_scroll_down(struct VDCWin *win, char by)
 // Scroll the window down, does not fill the new empty space
 {
-	unsigned sp = win->sp + vdc_state.width * win->wy;
-	unsigned cp = win->cp + vdc_state.width * win->wy;
+	unsigned sp = win->sp + VDC_ROWSTRIDE * win->wy;
+	unsigned cp = win->cp + VDC_ROWSTRIDE * win->wy;
 
 	char rx = win->wx;
 
-	int dst = vdc_state.width * by;
+	int dst = VDC_ROWSTRIDE * by;
 
 	for (char y = 0; y < win->wy - by; y++)
 	{
-		sp -= vdc_state.width;
-		cp -= vdc_state.width;
+		sp -= VDC_ROWSTRIDE;
+		cp -= VDC_ROWSTRIDE;
 		copy_fwd(sp, sp - dst, cp, cp - dst, rx);
 	}
 }
@@ -1031,7 +1050,7 @@ bool vdcwin_win_new(char border, char xpos, char ypos, char width, char height)
 	if ((border & WIN_BOR_UP) && ypos)
 	{
 		iheight++;
-		vdcaddress -= vdc_state.width;
+		vdcaddress -= VDC_ROWSTRIDE;
 	}
 	if ((border & WIN_BOR_BO) && ypos + height < vdc_state.height)
 	{
@@ -1071,7 +1090,7 @@ bool vdcwin_win_new(char border, char xpos, char ypos, char width, char height)
 		// Color
 		bnk_cpyfromvdc(winCfg.memcr, winCfg.memactive, vdc_state.base_attr + vdcaddress, iwidth);
 		winCfg.memactive += iwidth;
-		vdcaddress += vdc_state.width;
+		vdcaddress += VDC_ROWSTRIDE;
 	}
 
 	// Clear window and draw desired borders
@@ -1114,7 +1133,7 @@ void vdcwin_win_free()
 	if ((border & WIN_BOR_UP) && windows[winCfg.active - 1].win.sy)
 	{
 		iheight++;
-		vdcaddress -= vdc_state.width;
+		vdcaddress -= VDC_ROWSTRIDE;
 	}
 	if ((border & WIN_BOR_BO) && windows[winCfg.active - 1].win.sy + windows[winCfg.active - 1].win.wy < vdc_state.height)
 	{
@@ -1131,7 +1150,7 @@ void vdcwin_win_free()
 		// Color
 		bnk_cpytovdc(vdc_state.base_attr + vdcaddress, winCfg.memcr, winCfg.memactive, iwidth);
 		winCfg.memactive += iwidth;
-		vdcaddress += vdc_state.width;
+		vdcaddress += VDC_ROWSTRIDE;
 	}
 
 	// Make previous window if any active
@@ -1153,9 +1172,27 @@ void vdcwin_viewport_init(struct VDCViewport *vp, char sourcebank, char *sourceb
 	vp->sourceheight = sourceheight;
 	vp->sourcexoffset = 0;
 	vp->sourceyoffset = 0;
+	vp->sourcemono = 0;
+	vp->monoattr = 0;
+	vp->compositor = 0;
 	vdcwin_init(&vp->view, viewsx, viewsy, viewwidth, viewheight);
 }
 
+void vdcwin_viewport_mono(struct VDCViewport *vp, char mono, char monoattr)
+// Set a viewport source to mono or colour
+// Input: Viewport struct, mono flag (source has no attribute plane) and attribute to use for all cells in mono
+{
+	vp->sourcemono = mono;
+	vp->monoattr = monoattr;
+}
+
+void vdcwin_viewport_compositor(struct VDCViewport *vp, void (*compositor)(struct VDCViewport *vp))
+// Set a function to draw the viewport instead of the plain copy of the source screen map
+// Input: Viewport struct and compositor function, NULL to return to plain copy
+{
+	vp->compositor = compositor;
+}
+
 void vdcwin_cpy_viewport(struct VDCViewport *viewport)
 // Function to copy a viewport on the source screen map to the VDC
 // Input: Initialised viewport struct
@@ -1164,25 +1201,57 @@ void vdcwin_cpy_viewport(struct VDCViewport *viewport)
 	unsigned vdcbase = viewport->view.sp;
 	char *address = viewport->sourcebase + (viewport->sourceyoffset * viewport->sourcewidth) + viewport->sourcexoffset;
 
+	// Compositor draws the view itself
+	if (viewport->compositor)
+	{
+		viewport->compositor(viewport);
+		return;
+	}
+
 	for (char i = 0; i < viewport->view.wy; i++)
 	{
 		bnk_cpytovdc(vdcbase, viewport->sourcebank, address, viewport->view.wx);
-		vdcbase += vdc_state.width;
+		vdcbase += VDC_ROWSTRIDE;
 		address += viewport->sourcewidth;
 	}
 
 	// Attributes
 	vdcbase = viewport->view.cp;
+
+	// Mono source has no attribute plane: fill with the mono attribute
+	if (viewport->sourcemono)
+	{
+		for (char i = 0; i < viewport->view.wy; i++)
+		{
+			vdc_block_fill(vdcbase, viewport->monoattr, viewport->view.wx - 1);
+			vdcbase += VDC_ROWSTRIDE;
+		}
+		return;
+	}
+
 	address = viewport->sourcebase + (viewport->sourceyoffset * viewport->sourcewidth) + viewport->sourcexoffset + (viewport->sourceheight * viewport->sourcewidth) + 48;
 
 	for (char i = 0; i < viewport->view.wy; i++)
 	{
 		bnk_cpytovdc(vdcbase, viewport->sourcebank, address, viewport->view.wx);
-		vdcbase += vdc_state.width;
+		vdcbase += VDC_ROWSTRIDE;
 		address += viewport->sourcewidth;
 	}
 }
 
+void vdcwin_cpy_viewport_rect(struct VDCViewport *viewport, char x, char y, char w, char h)
+// Function to copy a part of a viewport on the source screen map to the VDC
+// Input: Initialised viewport struct, start coordinates and size of the part within the view
+{
+	struct VDCViewport vp_part;
+
+	memcpy(&vp_part, viewport, sizeof(vp_part));
+	vp_part.sourcexoffset += x;
+	vp_part.sourceyoffset += y;
+	vdcwin_init(&vp_part.view, viewport->view.sx + x, viewport->view.sy + y, w, h);
+	vdcwin_cpy_viewport(&vp_part);
+}
+
 void vdcwin_viewportscroll(struct VDCViewport *viewport, char direction)
 // Function to scroll a viewport on the source screen map on the VDC in the given direction
 // Input: Initialised viewport struct and direction
@@ -73,6 +73,9 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 #define WIN_MAX_NR 3      // Maximum number of windows (of memory allows)
 #define WIN_MEMORY 0x2000 // Maximum memory available for windows (now 4 KB)
 
+// Rightward line copies in place: most chunks of the shift distance before bouncing the line instead
+#define WIN_SHIFT_CHUNKS 2
+
 // Border flags
 #define WIN_BOR_UP 0x80    // Bit 7: set top border on (1) or off (0)
 #define WIN_BOR_LE 0x40    // Bit 6: set left border on (1) or off (0)
@@ -92,6 +95,9 @@ struct VDCViewport
     unsigned sourceheight;
     unsigned sourcexoffset;
     unsigned sourceyoffset;
+    char sourcemono;
+    char monoattr;
+    void (*compositor)(struct VDCViewport *vp);
     struct VDCWin view;
 };
 struct WinStyleStruct
@@ -260,9 +266,18 @@ void vdcwin_win_free();
 // Initialize a viewport of screen data in memory
 void vdcwin_viewport_init(struct VDCViewport *vp, char sourcebank, char *sourcebase, unsigned sourcewidth, unsigned sourceheight, unsigned viewwidth, unsigned viewheight, char viewsx, char viewsy);
 
+// Set a viewport source to mono (no attribute plane, all attributes set to monoattr) or colour
+void vdcwin_viewport_mono(struct VDCViewport *vp, char mono, char monoattr);
+
+// Set a compositor function drawing the viewport instead of the plain copy, or NULL for plain copy
+void vdcwin_viewport_compositor(struct VDCViewport *vp, void (*compositor)(struct VDCViewport *vp));
+
 // Copy a viewport on the source screen map to the VDC
 void vdcwin_cpy_viewport(struct VDCViewport *viewport);
 
+// Copy a part of a viewport on the source screen map to the VDC
+void vdcwin_cpy_viewport_rect(struct VDCViewport *viewport, char x, char y, char w, char h);
+
 // Scroll a viewport on the source screen map on the VDC in the given direction
 void vdcwin_viewportscroll(struct VDCViewport *viewport, char direction);
 
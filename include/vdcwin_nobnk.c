@@ -74,7 +74,7 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 #include "peekpoke.h"
 
 static inline void copy_fwd(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
-// Copy of a line direct from VDC source to VDC destination (for vertical based copy)
+// Copy of a line direct from VDC source to VDC destination (for vertical based copy and leftward copy in place)
 {
 	// Screen copy
 	vdc_block_copy(sdp, ssp, n);
@@ -82,20 +82,16 @@ static inline void copy_fwd(unsigned sdp, const unsigned ssp, unsigned cdp, cons
 	vdc_block_copy(cdp, csp, n);
 }
 
-static inline void copy_bwd(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
-// Copy of a line from VDC source via swap memory to VDC destination (for horizontal based copy)
+static inline void copy_right(unsigned sdp, const unsigned ssp, unsigned cdp, const unsigned csp, char n)
+// Copy of a line to a higher VDC address in place (for rightward horizontal copy)
+// The block copy runs forward, so the line is copied from the right in chunks of at most the shift distance.
+// Shifts needing more chunks, such as the single column of a pan, bounce the line through swap memory,
+// or stage it in linebuffer where swap memory is missing or is the attribute area of the mode.
 {
-	// Check if swap memory is available given screenmode and VDC memory size
-	if (!vdc_state.memextended && vdc_state.swap_text > 0x3ff)
-	{
-		// Screen copy via linebuffer
-		vdc_cpyfromvdc(linebuffer, ssp, n);
-		vdc_cpytovdc(sdp, linebuffer, n);
-		// Color copy via linebuffer
-		vdc_cpyfromvdc(linebuffer, csp, n);
-		vdc_cpytovdc(cdp, linebuffer, n);
-	}
-	else
+	char by = sdp - ssp;
+	char chunk;
+
+	if (n > (unsigned)by * WIN_SHIFT_CHUNKS && (vdc_state.memextended || vdc_state.swap_text <= 0x3ff) && vdc_state.swap_text != vdc_state.base_attr)
 	{
 		// Screen copy via swap VDC memory
 		vdc_block_copy(vdc_state.swap_text, ssp, n);
@@ -103,6 +99,29 @@ static inline void copy_bwd(unsigned sdp, const unsigned ssp, unsigned cdp, cons
 		// Color copy via swap VDC memory
 		vdc_block_copy(vdc_state.swap_text, csp, n);
 		vdc_block_copy(cdp, vdc_state.swap_text, n);
+		return;
+	}
+
+	if (n > (unsigned)by * WIN_SHIFT_CHUNKS)
+	{
+		// Lines are at most the screen width, which fits linebuffer
+		// Screen copy
+		vdc_cpyfromvdc(linebuffer, ssp, n);
+		vdc_cpytovdc(sdp, linebuffer, n);
+		// Color copy
+		vdc_cpyfromvdc(linebuffer, csp, n);
+		vdc_cpytovdc(cdp, linebuffer, n);
+		return;
+	}
+
+	while (n)
+	{
+		chunk = (n > by) ? by : n;
+		n -= chunk;
+		// Screen copy
+		vdc_block_copy(sdp + n, ssp + n, chunk);
+		// Color copy
+		vdc_block_copy(cdp + n, csp + n, chunk);
 	}
 }
 
@@ -616,7 +635,7 @@ void vdcwin_insert_char(struct VDCWin *win)
 
 	while (y > win->cy)
 	{
-		copy_bwd(sp + 1, sp, cp + 1, cp, rx);
+		copy_right(sp + 1, sp, cp + 1, cp, rx);
 
 		sp -= vdc_state.width;
 		cp -= vdc_state.width;
@@ -631,7 +650,7 @@ void vdcwin_insert_char(struct VDCWin *win)
 
 	if (rx)
 	{
-		copy_bwd(sp + 1, sp, cp + 1, cp, rx);
+		copy_right(sp + 1, sp, cp + 1, cp, rx);
 	}
 
 	vdc_mem_write_at(sp, ' ');
@@ -780,7 +799,7 @@ void vdcwin_scroll_left(struct VDCWin *win, char by)
 		//{
 		//	vdc_wait_no_vblank();
 		// }
-		copy_bwd(sp, sp + by, cp, cp + by, rx);
+		copy_fwd(sp, sp + by, cp, cp + by, rx);
 		sp += vdc_state.width;
 		cp += vdc_state.width;
 	}
@@ -797,7 +816,7 @@ void vdcwin_scroll_right(struct VDCWin *win, char by)
 
 	for (char y = 0; y < win->wy; y++)
 	{
-		copy_bwd(sp + by, sp, cp + by, cp, rx);
+		copy_right(sp + by, sp, cp + by, cp, rx);
 		sp += vdc_state.width;
 		cp += vdc_state.width;
 	}
@@ -75,6 +75,9 @@ THE PROGRAMS ARE DISTRIBUTED IN THE HOPE THAT THEY WILL BE USEFUL, BUT WITHOUT A
 #define SCROLL_DOWN 0x04
 #define SCROLL_UP 0x08
 
+// Rightward line copies in place: most chunks of the shift distance before bouncing the line instead
+#define WIN_SHIFT_CHUNKS 2
+
 // Structs
 #include "vdcwin_types.h"
 struct VDCViewport
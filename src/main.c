@@ -89,10 +89,98 @@ char overlay_active;
 // Undo data
 char undoenabled = 0;
 unsigned undoaddress;
-char undonumber;
-char undo_undopossible;
-char undo_redopossible;
-struct UndoStruct Undo[41];
+unsigned undo_undopossible;
+unsigned undo_redopossible;
+unsigned undo_tail;
+unsigned undo_current;
+struct UndoStruct undo_entry;
+unsigned undostart;
+unsigned long undoend;
+char undo_banked = 0;
+char undo_pending = 0;
+char undo_screendirty = 0;
+char undoload_pending = 0;
+struct UndoStatsStruct undo_stats;
+unsigned undoload_count;
+char undo_before[UNDO_CHUNK];
+char undo_after[UNDO_CHUNK];
+char undo_lit[128];
+char undo_litcount;
+char undo_runbyte;
+char undo_runcount;
+unsigned undo_encbase;
+unsigned undo_enclen;
+unsigned undo_enclimit;
+unsigned undo_encmax;
+char undo_groupcount = 0;
+unsigned undo_grouprow[UNDO_GROUP_MAX];
+unsigned undo_groupcol[UNDO_GROUP_MAX];
+char undo_groupcode[UNDO_GROUP_MAX];
+char undo_groupattr[UNDO_GROUP_MAX];
+unsigned undo_groupminrow;
+unsigned undo_groupmaxrow;
+unsigned undo_groupmincol;
+unsigned undo_groupmaxcol;
+
+// Character editor glyph history
+struct CharUndoStruct charundo[CHARUNDO_MAX];
+char charundo_newest;
+char charundo_undopossible = 0;
+char charundo_redopossible = 0;
+
+// Multiple screens data
+char screencount = 1;
+char screencurrent = 0;
+
+// Partial loading data
+char screenload_pending = 0;
+char screenload_planes;
+unsigned screenload_next;
+unsigned screenload_width;
+unsigned screenload_height;
+
+// Layers data
+char layershow = 0;
+unsigned layerhidden = 0;
+char layertransparent = CH_SPACE;
+char layerrow_chars[LAYER_ROWMAX];
+char layerrow_attrs[LAYER_ROWMAX];
+char layerrow_srcchars[LAYER_ROWMAX];
+char layerrow_srcattrs[LAYER_ROWMAX];
+
+// Hardware scrolled canvas data
+char hwscroll = 0;
+char hwscroll_x;
+char hwscroll_y;
+unsigned hwscroll_text;
+unsigned hwscroll_attr;
+
+// Cursor cell cache
+char cursor_cached = 0;
+unsigned cursor_cachecol;
+unsigned cursor_cacherow;
+char cursor_cellchar;
+char cursor_cellattr;
+
+// Status bar shadow, holding the values last drawn in the status bar
+char bar_valid = 0;
+char bar_mode[11];
+unsigned bar_x;
+unsigned bar_y;
+char bar_screencode;
+char bar_color;
+char bar_flags;
+char bar_screen;
+const unsigned bar_tens[4] = {10000, 1000, 100, 10};
+const char bar_hex[] = "0123456789ABCDEF";
+
+// Split view data
+char splitview = 0;
+struct VDCViewport refview;
+struct DirtyRect split_rect;
+
+// Canvas view dirty rectangle, redrawn by canvas_sync() instead of the whole view
+struct DirtyRect view_rect;
 
 // Global variables
 char bootdevice;
@@ -101,6 +189,7 @@ char charsetchanged[2];
 char appexit;
 char targetdevice;
 char filename[21];
+char saveformat = SAVEFORMAT_RAW;
 char programmode[11];
 char showbar;
 unsigned screen_col;
@@ -108,6 +197,8 @@ unsigned screen_row;
 struct VDCViewport canvas;
 unsigned screentotal;
 char screenbackground;
+char canvasmono = 0;
+char monocolor = VDC_WHITE;
 char plotscreencode;
 char plotcolor;
 char plotreverse;
@@ -453,15 +544,17 @@ void loadoverlay(char overlay_select)
 
 // Generic screen map routines
 char getmaxy()
-// Return the maximum y coordinate: either screen height or, if less, canvas height
+// Return the maximum y coordinate: either screen height (edited pane height in split view) or, if less, canvas height
 {
-    if (canvas.sourceheight < vdc_state.height)
+    char rows = splitview ? SPLIT_ROWS : vdc_state.height;
+
+    if (canvas.sourceheight < rows)
     {
         return canvas.sourceheight - 1;
     }
     else
     {
-        return vdc_state.height - 1;
+        return rows - 1;
     }
 }
 
@@ -478,66 +571,141 @@ char getmaxx()
     }
 }
 
+char *statusbar_digits(char *s, unsigned value, char width)
+// Write a number in decimal, right aligned in at least width columns, and return the end of it
+// Digits are found by subtracting powers of ten, as the 6502 has no divide
+{
+    char i, d;
+    char lead = 1;
+
+    for (i = 0; i < 4; i++)
+    {
+        d = '0';
+        while (value >= bar_tens[i])
+        {
+            value -= bar_tens[i];
+            d++;
+        }
+        if (d != '0' || !lead)
+        {
+            *s++ = d;
+            lead = 0;
+        }
+        else if (i + width >= 5)
+        {
+            *s++ = CH_SPACE;
+        }
+    }
+    *s++ = '0' + value;
+    *s = 0;
+    return s;
+}
+
 void printstatusbar()
 {
+    // Draw the fields of the status bar that changed since they were last drawn
+    // initstatusbar() clears bar_valid to draw all of them
+
     char ypos = vdc_state.height - 1;
+    unsigned x = screen_col + canvas.sourcexoffset;
+    unsigned y = screen_row + canvas.sourceyoffset;
+    char flags = (plotreverse ? 1 : 0) | (plotunderline ? 2 : 0) | (plotblink ? 4 : 0) | (plotaltchar ? 8 : 0);
+    char screen = (screencount > 1) ? screencurrent + 1 : 0;
+    char *p;
+    char i;
 
     if (screen_row == ypos)
     {
         return;
     }
 
-    vdc_state.text_attr = mc_menupopup;
-
-    sprintf(buffer, "%-10s", programmode);
-    vdc_prints(6, ypos, buffer);
-    sprintf(buffer, "%3u,%3u", screen_col + canvas.sourcexoffset, screen_row + canvas.sourceyoffset);
-    vdc_prints(22, ypos, buffer);
-    if (plotaltchar)
+    if (bar_valid && bar_x == x && bar_y == y && bar_screencode == plotscreencode && bar_color == plotcolor && bar_flags == flags && bar_screen == screen && !strcmp(bar_mode, programmode))
     {
-        vdc_printc(36, ypos, plotscreencode, mc_menupopup);
+        return;
     }
-    else
+
+    // Write while the VDC is in vertical blank
+    vdc_wait_vblank();
+    vdc_state.text_attr = mc_menupopup;
+
+    if (!bar_valid || strcmp(bar_mode, programmode))
     {
-        vdc_printc(36, ypos, plotscreencode, mc_menupopup - VDC_A_ALTCHAR);
+        strcpy(bar_mode, programmode);
+        for (i = 0; bar_mode[i]; i++)
+        {
+            buffer[i] = bar_mode[i];
+        }
+        for (; i < 10; i++)
+        {
+            buffer[i] = CH_SPACE;
+        }
+        buffer[i] = 0;
+        vdc_prints(6, ypos, buffer);
     }
-    sprintf(buffer, "%2X", plotscreencode);
-    vdc_prints(38, ypos, buffer);
-    vdc_printc(48, ypos, CH_SPACE, plotcolor + VDC_A_REVERSE);
-    sprintf(buffer, "%2u", plotcolor);
-    vdc_prints(50, ypos, buffer);
-    if (plotreverse)
+    if (!bar_valid || bar_x != x || bar_y != y)
     {
-        vdc_prints(54, ypos, "REV");
+        bar_x = x;
+        bar_y = y;
+        p = statusbar_digits(buffer, x, 3);
+        *p++ = ',';
+        statusbar_digits(p, y, 3);
+        vdc_prints(22, ypos, buffer);
     }
-    else
+    if (!bar_valid || bar_screencode != plotscreencode || (bar_flags ^ flags) & 8)
     {
-        vdc_prints(54, ypos, "   ");
+        bar_screencode = plotscreencode;
+        if (plotaltchar)
+        {
+            vdc_printc(36, ypos, plotscreencode, mc_menupopup);
+        }
+        else
+        {
+            vdc_printc(36, ypos, plotscreencode, mc_menupopup - VDC_A_ALTCHAR);
+        }
+        buffer[0] = (plotscreencode < 16) ? CH_SPACE : bar_hex[plotscreencode >> 4];
+        buffer[1] = bar_hex[plotscreencode & 15];
+        buffer[2] = 0;
+        vdc_prints(38, ypos, buffer);
     }
-    if (plotunderline)
+    if (!bar_valid || bar_color != plotcolor)
     {
-        vdc_prints(58, ypos, "UND");
+        bar_color = plotcolor;
+        vdc_printc(48, ypos, CH_SPACE, plotcolor + VDC_A_REVERSE);
+        statusbar_digits(buffer, plotcolor, 2);
+        vdc_prints(50, ypos, buffer);
     }
-    else
+    if (!bar_valid || (bar_flags ^ flags) & 1)
     {
-        vdc_prints(58, ypos, "   ");
+        vdc_prints(54, ypos, plotreverse ? "REV" : "   ");
     }
-    if (plotblink)
+    if (!bar_valid || (bar_flags ^ flags) & 2)
     {
-        vdc_prints(62, ypos, "BLI");
+        vdc_prints(58, ypos, plotunderline ? "UND" : "   ");
     }
-    else
+    if (!bar_valid || (bar_flags ^ flags) & 4)
     {
-        vdc_prints(62, ypos, "   ");
+        vdc_prints(62, ypos, plotblink ? "BLI" : "   ");
     }
-    if (plotaltchar)
+    if (!bar_valid || (bar_flags ^ flags) & 8)
     {
-        vdc_prints(66, ypos, "ALT");
+        vdc_prints(66, ypos, plotaltchar ? "ALT" : "   ");
     }
-    else
+    bar_flags = flags;
+    if (!bar_valid || bar_screen != screen)
     {
-        vdc_prints(66, ypos, "   ");
+        bar_screen = screen;
+        if (screen)
+        {
+            buffer[0] = 'S';
+            statusbar_digits(buffer + 1, screen, 1);
+            vdc_prints(70, ypos, buffer);
+        }
+        else
+        {
+            vdc_prints(70, ypos, "  ");
+        }
     }
+    bar_valid = 1;
 }
 
 void initstatusbar()
@@ -552,6 +720,7 @@ void initstatusbar()
     vdc_state.text_attr = mc_menupopup;
 
     vdc_clear(0, ypos, CH_SPACE, 80, 1);
+    bar_valid = 0;
     vdc_prints(0, ypos, "Mode:");
     vdc_prints(17, ypos, "X,Y:");
     vdc_prints(31, ypos, "Char:");
@@ -562,6 +731,15 @@ void initstatusbar()
 
 void hidestatusbar()
 {
+    bar_valid = 0;
+
+    // In split view the bottom row is below the reference pane
+    if (splitview)
+    {
+        vdc_state.text_attr = VDC_WHITE;
+        vdc_clear(0, vdc_state.height - 1, CH_SPACE, vdc_state.width, 1);
+        return;
+    }
     vdcwin_cpy_viewport(&canvas);
 }
 
@@ -598,13 +776,188 @@ char *screenmap_attraddr(unsigned row, unsigned col, unsigned width, unsigned he
     return (char *)(SCREENMAPBASE + (row * width) + col + (width * height) + 48);
 }
 
+void screenmap_rowmove(char *dest, char *src, unsigned width)
+{
+    // Function to move a row part within the Bank 1 screen map, source and destination may overlap
+    // Staged through the VDC swap area, or in chunks through linebuffer in Bank 0 if the swap area is
+    // the attribute area on screen (mono modes on a 16 KB VDC)
+
+    unsigned chunk, done;
+
+    if (vdc_state.swap_text != vdc_state.base_attr)
+    {
+        bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, src, width);
+        bnk_cpyfromvdc(BNK_1_FULL, dest, vdc_state.swap_text, width);
+        return;
+    }
+
+    // Moving up in memory starts with the last chunk, so no source byte is overwritten before it is read
+    for (done = 0; done < width; done += chunk)
+    {
+        chunk = (width - done > 80) ? 80 : width - done;
+        if (dest > src)
+        {
+            bnk_memcpy(BNK_0_FULL, linebuffer, BNK_1_FULL, src + width - done - chunk, chunk);
+            bnk_memcpy(BNK_1_FULL, dest + width - done - chunk, BNK_0_FULL, linebuffer, chunk);
+        }
+        else
+        {
+            bnk_memcpy(BNK_0_FULL, linebuffer, BNK_1_FULL, src + done, chunk);
+            bnk_memcpy(BNK_1_FULL, dest + done, BNK_0_FULL, linebuffer, chunk);
+        }
+    }
+}
+
+char screenmap_readattr(unsigned row, unsigned col)
+{
+    // Function to read the attribute of a screenmap position
+    // Returns the global mono colour if the canvas has no attribute plane
+
+    if (canvasmono)
+    {
+        return monocolor;
+    }
+    return bnk_readb(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight));
+}
+
+// Split view
+// The edited pane is the canvas viewport at the top, the reference pane a second viewport on the same screen map
+// below a divider row. Edits mark their area dirty; split_sync() copies only the part of it the reference pane shows.
+
+static void dirty_mark(struct DirtyRect *rect, unsigned row, unsigned col, unsigned width, unsigned height)
+{
+    // Function to grow a dirty rectangle with an area of the screen map
+
+    if (!rect->dirty)
+    {
+        rect->dirty = 1;
+        rect->minrow = row;
+        rect->mincol = col;
+        rect->maxrow = row + height - 1;
+        rect->maxcol = col + width - 1;
+        return;
+    }
+    if (row < rect->minrow)
+    {
+        rect->minrow = row;
+    }
+    if (col < rect->mincol)
+    {
+        rect->mincol = col;
+    }
+    if (row + height - 1 > rect->maxrow)
+    {
+        rect->maxrow = row + height - 1;
+    }
+    if (col + width - 1 > rect->maxcol)
+    {
+        rect->maxcol = col + width - 1;
+    }
+}
+
+static char dirty_sync(struct DirtyRect *rect, struct VDCViewport *vp)
+{
+    // Function to draw the intersection of a dirty rectangle and the area a viewport shows, and clear the rectangle
+    // The viewport compositor draws the part if layers are shown
+    // Returns the screen row below the drawn part, 0 if nothing was drawn
+
+    unsigned top, left, bottom, right;
+
+    if (!rect->dirty)
+    {
+        return 0;
+    }
+    rect->dirty = 0;
+    top = (rect->minrow > vp->sourceyoffset) ? rect->minrow : vp->sourceyoffset;
+    left = (rect->mincol > vp->sourcexoffset) ? rect->mincol : vp->sourcexoffset;
+    bottom = vp->sourceyoffset + vp->view.wy - 1;
+    right = vp->sourcexoffset + vp->view.wx - 1;
+    if (rect->maxrow < bottom)
+    {
+        bottom = rect->maxrow;
+    }
+    if (rect->maxcol < right)
+    {
+        right = rect->maxcol;
+    }
+    if (top > bottom || left > right)
+    {
+        return 0;
+    }
+    vdcwin_cpy_viewport_rect(vp, left - vp->sourcexoffset, top - vp->sourceyoffset, right - left + 1, bottom - top + 1);
+    return vp->view.sy + bottom - vp->sourceyoffset + 1;
+}
+
+void split_sync()
+{
+    // Function to copy the intersection of the dirty rectangle and the reference pane to the reference pane
+
+    if (split_rect.dirty)
+    {
+        refview.compositor = canvas.compositor;
+        dirty_sync(&split_rect, &refview);
+    }
+}
+
+void canvas_sync()
+{
+    // Function to redraw the part of the canvas view changed by edits since the last redraw
+    // With layers shown only that part is composited again; the cursor cell cache is read again afterwards
+
+    if (view_rect.dirty)
+    {
+        cursor_cached = 0;
+
+        // The status bar covers the last screen row
+        if (dirty_sync(&view_rect, &canvas) == vdc_state.height && showbar)
+        {
+            initstatusbar();
+        }
+    }
+}
+
+void screenmap_dirty(unsigned row, unsigned col, unsigned width, unsigned height)
+{
+    // Function to note a change of an area of the screen map for the cursor cell cache, the canvas view
+    // and the reference pane of the split view
+
+    cursor_cached = 0;
+    dirty_mark(&view_rect, row, col, width, height);
+    if (splitview)
+    {
+        dirty_mark(&split_rect, row, col, width, height);
+    }
+}
+
+void split_redraw()
+{
+    // Function to draw the divider row and the full reference pane of the split view
+
+    char rows = vdc_state.height - SPLIT_ROWS - 2;
+
+    if (rows > canvas.sourceheight)
+    {
+        rows = canvas.sourceheight;
+    }
+    vdcwin_init(&refview.view, 0, SPLIT_ROWS + 1, getmaxx() + 1, rows);
+    refview.compositor = canvas.compositor;
+    vdc_hchar(0, SPLIT_ROWS, CH_SPACE, mc_menupopup, vdc_state.width);
+    vdc_prints_attr(1, SPLIT_ROWS, "Reference", mc_menupopup);
+    vdcwin_cpy_viewport(&refview);
+    split_rect.dirty = 0;
+}
+
 void screenmapplot(char row, char col, char screencode, char attribute)
 {
     // Function to plot a screencodes at bank 1 memory screen map
-    // Input: row and column, screencode to plot, attribute code
+    // Input: row and column, screencode to plot, attribute code (ignored for mono canvas)
 
     bnk_writeb(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), screencode);
-    bnk_writeb(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), attribute);
+    if (!canvasmono)
+    {
+        bnk_writeb(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), attribute);
+    }
+    screenmap_dirty(row, col, 1, 1);
 }
 
 void placesignature()
@@ -629,236 +982,2488 @@ void screenmapfill(char screencode, char attribute)
 
     unsigned address = SCREENMAPBASE;
 
+    cursor_cached = 0;
     bnk_memset(BNK_1_FULL, (char *)address, screencode, screentotal + 48);
     placesignature();
-    address += screentotal + 48;
-    bnk_memset(BNK_1_FULL, (char *)address, attribute, screentotal);
+    if (!canvasmono)
+    {
+        address += screentotal + 48;
+        bnk_memset(BNK_1_FULL, (char *)address, attribute, screentotal);
+    }
 }
 
-void cursormove(char left, char right, char up, char down)
+// Functions for partial loading of row format screen files
+// The file stays open on BNK_STREAM_FNUM while rows are pending, the main loop loads them while idle
+
+char screenload_rows(unsigned upto)
 {
-    // Move cursor and scroll screen if needed
-    // Input: flags to enable (1) or disable (0) move in the different directions
+    // Function to load pending rows of a row format screen file up to (not including) the given row
+    // Returns 0 on file error
 
-    if (left == 1)
-    {
-        if (screen_col == 0)
-        {
-            if (canvas.sourcexoffset > 0)
-            {
-                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-                vdcwin_viewportscroll(&canvas, SCROLL_LEFT);
-                initstatusbar();
-            }
-        }
-        else
-        {
-            vdcwin_cursor_move(&canvas.view, --screen_col, screen_row);
-        }
-    }
-    if (right == 1)
+    if (upto > screenload_height)
     {
-        if (screen_col == getmaxx())
-        {
-            if (canvas.sourcexoffset + screen_col < canvas.sourcewidth - 1)
-            {
-                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-                vdcwin_viewportscroll(&canvas, SCROLL_RIGHT);
-                initstatusbar();
-            }
-        }
-        else
-        {
-            vdcwin_cursor_move(&canvas.view, ++screen_col, screen_row);
-        }
+        upto = screenload_height;
     }
-    if (up == 1)
+
+    while (screenload_pending && screenload_next < upto)
     {
-        if (screen_row == 0)
-        {
-            if (canvas.sourceyoffset > 0)
-            {
-                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-                vdcwin_viewportscroll(&canvas, SCROLL_UP);
-                initstatusbar();
-            }
-        }
-        else
+        if (bnk_io_read(BNK_STREAM_FNUM, BNK_1_FULL, screenmap_screenaddr(screenload_next, 0, screenload_width), screenload_width) != screenload_width ||
+            (screenload_planes > 1 && bnk_io_read(BNK_STREAM_FNUM, BNK_1_FULL, screenmap_attraddr(screenload_next, 0, screenload_width, screenload_height), screenload_width) != screenload_width))
         {
-            vdcwin_cursor_move(&canvas.view, screen_col, --screen_row);
-            if (showbar && screen_row == vdc_state.height - 2)
-            {
-                initstatusbar();
-            }
+            krnio_close(BNK_STREAM_FNUM);
+            screenload_pending = 0;
+            menu_fileerrormessage();
+            return 0;
         }
+        screenload_next++;
     }
-    if (down == 1)
+
+    if (screenload_pending && screenload_next >= screenload_height)
     {
-        if (screen_row == vdc_state.height - 2)
-        {
-            hidestatusbar();
-        }
-        if (screen_row == getmaxy())
-        {
-            if (canvas.sourceyoffset + screen_row < canvas.sourceheight - 1)
-            {
-                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-                vdcwin_viewportscroll(&canvas, SCROLL_DOWN);
-                initstatusbar();
-            }
-        }
-        else
-        {
-            vdcwin_cursor_move(&canvas.view, screen_col, ++screen_row);
-        }
+        krnio_close(BNK_STREAM_FNUM);
+        screenload_pending = 0;
     }
+    return 1;
 }
 
-void plotcursor()
-// Plot cursor at present position
+void screenload_finish()
 {
-    vdc_printc(screen_col, screen_row, plotscreencode, VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
-    vdcwin_cursor_toggle(&canvas.view);
-}
+    // Function to load all pending rows, needed before anything else uses the screen map or the disk
 
-void hidecursor()
-// Hide the cursor
-{
-    vdc_printc(screen_col, screen_row, bnk_readb(BNK_1_FULL, screenmap_screenaddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth)), bnk_readb(BNK_1_FULL, screenmap_attraddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth, canvas.sourceheight)));
+    if (screenload_pending)
+    {
+        screenload_rows(screenload_height);
+    }
 }
 
-void resetcursor()
-// Reset cursor after window
+char screenload_idlekey(char key)
 {
-    vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-    plotcursor();
+    // Function to check if a main mode key can be handled while rows are pending
+    // Only keys changing the pen or the cell at the cursor within the loaded rows
+
+    switch (key)
+    {
+    case CH_CURS_LEFT:
+    case CH_CURS_RIGHT:
+    case CH_CURS_UP:
+    case CH_CURS_DOWN:
+    case CH_SPACE:
+    case CH_DEL:
+    case '+':
+    case '-':
+    case ',':
+    case '.':
+    case 'i':
+        return 1;
+
+    default:
+        return 0;
+    }
 }
 
-// Functions for undo system
+// Functions for the hardware scrolled canvas
+// With 64 KiB VDC memory the canvas is shown from a strip in VDC memory larger than the screen, with a row
+// stride of the screen width plus HWSCROLL_SKIP set in the VDC row increment register. Scrolling moves the
+// display start within the strip, so only the exposed row or column is copied from the screen map, and the
+// move glides over the VDC fine scroll registers by HWSCROLL_FINESTEP pixels per frame.
+// At the edge of the strip the display start jumps to the opposite edge and the whole view is copied.
 
-void undo_new(unsigned row, unsigned col, unsigned width, unsigned height)
+void hwscroll_setstart(char display)
 {
-    // Function to create a new undo buffer position
+    // Function to move the screen base and the canvas view to the strip position
+    // Input: display flag to also set the VDC display start (1) or only the addresses drawn to (0)
 
-    unsigned y;
-    char redoroompresent = 1;
-    unsigned long undoaddress_next;
-    unsigned long undo_bytes = UNDO_BUFFER_BYTES(width, height, 1);
+    unsigned offset = vdc_coords(hwscroll_x, hwscroll_y);
 
-    if (undo_redopossible > 0)
-    {
-        undo_undopossible = 1;
-        undo_redopossible = 0;
-    }
-    else
+    vdc_state.base_text = hwscroll_text + offset;
+    vdc_state.base_attr = hwscroll_attr + offset;
+    canvas.view.sp = vdc_state.base_text + vdc_coords(canvas.view.sx, canvas.view.sy);
+    canvas.view.cp = vdc_state.base_attr + vdc_coords(canvas.view.sx, canvas.view.sy);
+
+    if (display)
     {
-        undo_undopossible++;
+        vdc_wait_vblank();
+        vdc_set_disp_address(vdc_state.base_text, vdc_state.base_attr);
     }
-    undonumber++;
-    if (undonumber > 40)
+}
+
+void hwscroll_init()
+{
+    // Function to lay out the canvas strip after setting a screen mode
+    // The strip is placed at the start of the extended VDC memory, screens and undo move up above it
+    // Without 64 KiB VDC memory or if too little memory is left above the strip, the canvas scrolls by copying
+
+    unsigned area = (vdc_state.width + HWSCROLL_SKIP) * (vdc_state.height + HWSCROLL_MARGIN);
+
+    hwscroll = 0;
+    if (vdc_state.memsize != 64 || vdc_modes[vdc_state.mode].extended + (2UL * area) + HWSCROLL_MINSPARE > 0x10000UL)
     {
-        undonumber = 1;
+        return;
     }
-    undoaddress_next = (unsigned long)undoaddress + undo_bytes;
-    if (undoaddress_next > 0x10000UL)
+
+    hwscroll = 1;
+    hwscroll_x = 0;
+    hwscroll_y = 0;
+    hwscroll_text = vdc_modes[vdc_state.mode].extended;
+    hwscroll_attr = hwscroll_text + area;
+    vdc_state.extended = hwscroll_attr + area;
+    vdc_state.disp_skip = HWSCROLL_SKIP;
+    vdc_set_multab();
+    vdc_reg_write(VDCR_ROWINC, HWSCROLL_SKIP);
+    hwscroll_setstart(1);
+}
+
+void hwscroll_exit()
+{
+    // Function to return to the plain screen layout of the mode, for full screens loaded as one block
+    // The strip memory stays reserved, hwscroll_init() lays it out again
+
+    if (!hwscroll)
     {
-        undonumber = 1;
-        undoaddress = vdc_state.extended;
-        undoaddress_next = (unsigned long)undoaddress + undo_bytes;
+        return;
     }
-    if (undoaddress_next > (0x10000UL - (unsigned long)vdc_state.extended))
+
+    hwscroll = 0;
+    vdc_state.base_text = vdc_modes[vdc_state.mode].base_text;
+    vdc_state.base_attr = vdc_modes[vdc_state.mode].base_attr;
+    vdc_state.disp_skip = 0;
+    vdc_set_multab();
+    vdc_reg_write(VDCR_ROWINC, 0);
+    vdc_set_disp_address(vdc_state.base_text, vdc_state.base_attr);
+}
+
+void hwscroll_glide(char direction)
+{
+    // Function to move the display start to the new strip position with fine scrolling, a step per frame
+    // Down and right glide towards the exposed row or column before the coarse move, up and left glide it in after
+
+    char vertical = direction & (SCROLL_UP | SCROLL_DOWN);
+    char reg = vertical ? VDCR_VSCROLL : VDCR_HSCROLL;
+    char base = vdc_reg_read(VDCR_VSCROLL) & 0xe0;
+    char fine;
+
+    // Horizontal fine scroll counts down from the default offset, which needs room for the steps
+    if (!vertical)
     {
-        redoroompresent = 0;
-        undo_bytes = UNDO_BUFFER_BYTES(width, height, 0);
+        base = vdc_reg_read(VDCR_HSCROLL);
+        if ((base & 0x0f) < 8 - HWSCROLL_FINESTEP)
+        {
+            hwscroll_setstart(1);
+            return;
+        }
     }
-    for (y = 0; y < height; y++)
+
+    if (direction & (SCROLL_DOWN | SCROLL_RIGHT))
     {
-        bnk_cpytovdc(undoaddress + (y * width), BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), width);
-        bnk_cpytovdc(undoaddress + (width * height) + (y * width), BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), width);
+        for (fine = HWSCROLL_FINESTEP; fine < 8; fine += HWSCROLL_FINESTEP)
+        {
+            vdc_wait_vblank();
+            vdc_reg_write(reg, vertical ? base + fine : base - fine);
+            vdc_wait_no_vblank();
+        }
+        hwscroll_setstart(1);
+        vdc_reg_write(reg, base);
+        vdc_wait_no_vblank();
     }
-    Undo[undonumber - 1].address = undoaddress;
-    if (undonumber < 40)
+    else
     {
-        Undo[undonumber].address = 0;
+        hwscroll_setstart(1);
+        fine = 8;
+        do
+        {
+            fine -= HWSCROLL_FINESTEP;
+            vdc_reg_write(reg, vertical ? base + fine : base - fine);
+            vdc_wait_no_vblank();
+            if (fine)
+            {
+                vdc_wait_vblank();
+            }
+        } while (fine);
+    }
+}
+
+void canvas_scroll(char direction)
+{
+    // Function to scroll the canvas view one position in the given direction
+    // Without a strip, with windows open or in split view the view is scrolled by copying
+
+    struct VDCViewport vp_fill;
+    char full = 0;
+
+    if (!hwscroll || winCfg.active || splitview)
+    {
+        vdcwin_viewportscroll(&canvas, direction);
+        return;
+    }
+
+    if (direction & SCROLL_LEFT)
+    {
+        canvas.sourcexoffset--;
+        if (hwscroll_x)
+        {
+            hwscroll_x--;
+        }
+        else
+        {
+            hwscroll_x = HWSCROLL_SKIP;
+            full = 1;
+        }
+    }
+    if (direction & SCROLL_RIGHT)
+    {
+        canvas.sourcexoffset++;
+        if (hwscroll_x < HWSCROLL_SKIP)
+        {
+            hwscroll_x++;
+        }
+        else
+        {
+            hwscroll_x = 0;
+            full = 1;
+        }
+    }
+    if (direction & SCROLL_UP)
+    {
+        canvas.sourceyoffset--;
+        if (hwscroll_y)
+        {
+            hwscroll_y--;
+        }
+        else
+        {
+            hwscroll_y = HWSCROLL_MARGIN;
+            full = 1;
+        }
+    }
+    if (direction & SCROLL_DOWN)
+    {
+        canvas.sourceyoffset++;
+        if (hwscroll_y < HWSCROLL_MARGIN)
+        {
+            hwscroll_y++;
+        }
+        else
+        {
+            hwscroll_y = 0;
+            full = 1;
+        }
+    }
+
+    // Draw at the new position before moving the display start, so an exposed row or column is not yet shown
+    hwscroll_setstart(0);
+    if (full)
+    {
+        vdcwin_cpy_viewport(&canvas);
+        hwscroll_setstart(1);
+    }
+    else
+    {
+        memcpy(&vp_fill, &canvas, sizeof(vp_fill));
+        if (direction & SCROLL_LEFT)
+        {
+            vdcwin_init(&vp_fill.view, canvas.view.sx, canvas.view.sy, 1, canvas.view.wy);
+        }
+        if (direction & SCROLL_RIGHT)
+        {
+            vp_fill.sourcexoffset += canvas.view.wx - 1;
+            vdcwin_init(&vp_fill.view, canvas.view.sx + canvas.view.wx - 1, canvas.view.sy, 1, canvas.view.wy);
+        }
+        if (direction & SCROLL_UP)
+        {
+            vdcwin_init(&vp_fill.view, canvas.view.sx, canvas.view.sy, canvas.view.wx, 1);
+        }
+        if (direction & SCROLL_DOWN)
+        {
+            vp_fill.sourceyoffset += canvas.view.wy - 1;
+            vdcwin_init(&vp_fill.view, canvas.view.sx, canvas.view.sy + canvas.view.wy - 1, canvas.view.wx, 1);
+        }
+        vdcwin_cpy_viewport(&vp_fill);
+        hwscroll_glide(direction);
+    }
+}
+
+void cursormove(char left, char right, char up, char down)
+{
+    // Move cursor and scroll screen if needed
+    // Input: flags to enable (1) or disable (0) move in the different directions
+
+    if (left == 1)
+    {
+        if (screen_col == 0)
+        {
+            if (canvas.sourcexoffset > 0)
+            {
+                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+                canvas_scroll(SCROLL_LEFT);
+                initstatusbar();
+            }
+        }
+        else
+        {
+            vdcwin_cursor_move(&canvas.view, --screen_col, screen_row);
+        }
+    }
+    if (right == 1)
+    {
+        if (screen_col == getmaxx())
+        {
+            if (canvas.sourcexoffset + screen_col < canvas.sourcewidth - 1)
+            {
+                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+                canvas_scroll(SCROLL_RIGHT);
+                initstatusbar();
+            }
+        }
+        else
+        {
+            vdcwin_cursor_move(&canvas.view, ++screen_col, screen_row);
+        }
+    }
+    if (up == 1)
+    {
+        if (screen_row == 0)
+        {
+            if (canvas.sourceyoffset > 0)
+            {
+                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+                canvas_scroll(SCROLL_UP);
+                initstatusbar();
+            }
+        }
+        else
+        {
+            vdcwin_cursor_move(&canvas.view, screen_col, --screen_row);
+            if (showbar && screen_row == vdc_state.height - 2)
+            {
+                initstatusbar();
+            }
+        }
+    }
+    if (down == 1)
+    {
+        if (screen_row == vdc_state.height - 2)
+        {
+            hidestatusbar();
+        }
+        if (screen_row == getmaxy())
+        {
+            if (canvas.sourceyoffset + screen_row < canvas.sourceheight - 1)
+            {
+                vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+                canvas_scroll(SCROLL_DOWN);
+                initstatusbar();
+            }
+        }
+        else
+        {
+            vdcwin_cursor_move(&canvas.view, screen_col, ++screen_row);
+        }
+    }
+}
+
+void cursor_cache()
+// Remember the cell under the cursor from the VDC, which shows the screen map there while the cursor is not drawn
+{
+    unsigned address = vdc_coords(screen_col, screen_row);
+
+    cursor_cellchar = vdc_mem_read_at(vdc_state.base_text + address);
+    cursor_cellattr = vdc_mem_read_at(vdc_state.base_attr + address);
+    cursor_cachecol = canvas.sourcexoffset + screen_col;
+    cursor_cacherow = canvas.sourceyoffset + screen_row;
+    cursor_cached = 1;
+}
+
+void plotcursor()
+// Plot cursor at present position, with reverse and blink toggled to show it
+{
+    canvas_sync();
+    split_sync();
+    vdc_printc(screen_col, screen_row, plotscreencode, (canvasmono ? monocolor : VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar)) ^ (VDC_A_REVERSE | VDC_A_BLINK));
+}
+
+void hidecursor()
+// Hide the cursor
+{
+    // With layers shown, recomposite the cell
+    if (canvas.compositor)
+    {
+        vdcwin_cpy_viewport_rect(&canvas, screen_col, screen_row, 1, 1);
+        return;
+    }
+
+    // Restore from the cache if it holds this cell, else read it from the screen map
+    if (cursor_cached && cursor_cachecol == canvas.sourcexoffset + screen_col && cursor_cacherow == canvas.sourceyoffset + screen_row)
+    {
+        vdc_printc(screen_col, screen_row, cursor_cellchar, cursor_cellattr);
+        return;
+    }
+    vdc_printc(screen_col, screen_row, bnk_readb(BNK_1_FULL, screenmap_screenaddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth)), screenmap_readattr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col));
+}
+
+void resetcursor()
+// Reset cursor after window
+{
+    vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+    plotcursor();
+}
+
+// Functions for undo system
+
+void charundo_clear()
+{
+    // Function to clear the glyph history of the character editor, as its deltas only fit the present charsets
+
+    charundo_undopossible = 0;
+    charundo_redopossible = 0;
+}
+
+// Undo memory
+// Undo data lives in VDC memory above the screen, charsets and cached screens if 64 KiB VDC memory is
+// present. Else it lives in Bank 1 between the end of the screen map and MEMORYLIMIT, so the room for
+// undo shrinks as the canvas grows. All undo data access goes through these functions.
+
+static char undostore_read(unsigned address)
+{
+    // Function to read a byte of undo memory
+
+    return (undo_banked) ? bnk_readb(BNK_1_FULL, (char *)address) : vdc_mem_read_at(address);
+}
+
+static void undostore_write(unsigned address, char b)
+{
+    // Function to write a byte of undo memory
+
+    if (undo_banked)
+    {
+        bnk_writeb(BNK_1_FULL, (char *)address, b);
+    }
+    else
+    {
+        vdc_mem_write_at(address, b);
+    }
+}
+
+static void undostore_put(unsigned address, char cr, char *sp, unsigned size)
+{
+    // Function to copy memory of the given bank to undo memory
+
+    if (undo_banked)
+    {
+        bnk_memcpy(BNK_1_FULL, (char *)address, cr, sp, size);
+    }
+    else
+    {
+        bnk_cpytovdc(address, cr, sp, size);
+    }
+}
+
+void undostore_get(char cr, char *dp, unsigned address, unsigned size)
+{
+    // Function to copy undo memory to memory of the given bank
+
+    if (undo_banked)
+    {
+        bnk_memcpy(cr, dp, BNK_1_FULL, (char *)address, size);
+    }
+    else
+    {
+        bnk_cpyfromvdc(cr, dp, address, size);
+    }
+}
+
+static void undostore_copy(unsigned dest, unsigned src, unsigned size)
+{
+    // Function to copy within undo memory to a lower address, at most 255 bytes
+
+    if (undo_banked)
+    {
+        bnk_memcpy(BNK_1_FULL, (char *)dest, BNK_1_FULL, (char *)src, size);
+    }
+    else
+    {
+        vdc_block_copy_page(dest, src, size);
+    }
+}
+
+// Undo log
+// Every entry is a header (struct UndoStruct) followed by its data in VDC memory. The headers link
+// the entries from oldest to newest: undo_tail is the oldest live entry, undo_current the entry a
+// next undo restores. Entries after undo_current form the redo chain. Only the counters and the
+// header of the entry being worked on (undo_entry) are kept in main RAM.
+
+void undo_readheader(unsigned address)
+{
+    // Function to read the header of an undo entry into undo_entry
+
+    undostore_get(BNK_0_FULL, (char *)&undo_entry, address, UNDO_HEADER);
+}
+
+static void undo_writeheader(unsigned address)
+{
+    // Function to write undo_entry as header of an undo entry
+
+    undostore_put(address, BNK_0_FULL, (char *)&undo_entry, UNDO_HEADER);
+}
+
+static unsigned undo_getnext(unsigned address)
+{
+    // Function to get the address of the entry following an undo entry
+
+    return undostore_read(address + UNDO_NEXT) | (undostore_read(address + UNDO_NEXT + 1) << 8);
+}
+
+static void undo_setnext(unsigned address, unsigned next)
+{
+    // Function to set the address of the entry following an undo entry
+
+    undostore_write(address + UNDO_NEXT, next & 0xff);
+    undostore_write(address + UNDO_NEXT + 1, next >> 8);
+}
+
+// Undo memory allocation
+// Undo data is allocated at the write head undoaddress, wrapping to undostart at the end of VDC memory.
+// Data ahead of the head is the oldest, so room is made by evicting the oldest undo entries, freeing
+// bytes instead of slots. Entries in the redo chain and the entry being undone are never evicted.
+// Redo images are only allocated when an entry without delta is undone.
+
+static unsigned undo_oldest()
+{
+    // Function to get the VDC address of the oldest live undo entry, 0 if there is none
+
+    if (!undo_undopossible && !undo_redopossible)
+    {
+        return 0;
+    }
+    return undo_tail;
+}
+
+static char undo_evict(unsigned keep)
+{
+    // Function to drop the oldest undo entry
+    // keep: number of newest undo entries that may not be dropped
+
+    if (undo_undopossible <= keep)
+    {
+        return 0;
+    }
+    undo_tail = undo_getnext(undo_tail);
+    undo_undopossible--;
+    undo_stats.evictions++;
+    return 1;
+}
+
+void undo_stats_update()
+{
+    // Function to update the undo memory usage in undo_stats
+    // Used counts from the oldest entry to the write head, including space freed by dropped redo images
+
+    unsigned oldest = undo_oldest();
+    unsigned size = (unsigned)(undoend - undostart);
+
+    undo_stats.used = 0;
+    if (oldest)
+    {
+        if (undoaddress >= oldest)
+        {
+            undo_stats.used = undoaddress - oldest;
+        }
+        else
+        {
+            undo_stats.used = (unsigned)(undoend - oldest) + (undoaddress - undostart);
+        }
+    }
+    undo_stats.free = size - undo_stats.used;
+    undo_stats.entries = undo_undopossible + undo_redopossible;
+}
+
+static unsigned undo_freeahead(unsigned long address)
+{
+    // Function to get the free undo memory from an address up to the next live entry or the end of VDC memory
+
+    unsigned long next = undoend;
+    unsigned oldest;
+
+    if (undo_undopossible || undo_redopossible)
+    {
+        oldest = undo_oldest();
+        if (oldest >= address)
+        {
+            next = oldest;
+        }
+    }
+    return (next > address) ? (unsigned)(next - address) : 0;
+}
+
+static unsigned undo_alloc(unsigned long bytes, unsigned keep)
+{
+    // Function to allocate undo memory at the write head, evicting the oldest entries in the way
+    // keep: number of newest undo entries that may not be evicted
+    // Returns the VDC address, or 0 if not enough memory can be freed
+
+    unsigned long head = (undoaddress < undostart) ? undoend : undoaddress;
+    unsigned long start = head;
+    unsigned long end;
+    unsigned oldest;
+    char wrap = 0;
+
+    if (start + bytes > undoend)
+    {
+        start = undostart;
+        wrap = 1;
+        if (start + bytes > undoend)
+        {
+            return 0;
+        }
+    }
+    end = start + bytes;
+    while (undo_undopossible || undo_redopossible)
+    {
+        oldest = undo_oldest();
+        if (wrap ? (oldest < end || oldest >= head) : (oldest >= start && oldest < end))
+        {
+            if (!undo_evict(keep))
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    return (unsigned)start;
+}
+
+// Delta encoding of undo entries
+// An entry first holds the raw before image. When the next undo action comes, it is replaced by the XOR
+// of the before and after image, run length encoded: runs of 3 to 129 equal bytes as count + 126 and
+// the byte, literals of 1 to 128 bytes as count - 1 and the bytes. Applying the delta switches the
+// screen map between before and after image, so it serves both undo and redo.
+
+static void undo_encgrow()
+{
+    // Function to make room for more delta bytes by evicting the oldest undo entry directly ahead
+
+    if (undo_undopossible > 1 && undo_oldest() >= undo_encbase)
+    {
+        undo_evict(1);
+        undo_enclimit = undo_freeahead(undo_encbase);
+        if (undo_enclimit > undo_encmax)
+        {
+            undo_enclimit = undo_encmax;
+        }
+    }
+}
+
+static void undo_encemit(char b)
+{
+    // Function to write a byte of the encoded delta, stops writing if no more room can be made
+
+    if (undo_enclen == undo_enclimit && undo_enclimit < undo_encmax)
+    {
+        undo_encgrow();
+    }
+    if (undo_enclen < undo_enclimit)
+    {
+        undostore_write(undo_encbase + undo_enclen, b);
+    }
+    undo_enclen++;
+}
+
+static void undo_encliterals()
+{
+    // Function to write the pending literal bytes
+
+    char i;
+
+    if (undo_litcount)
+    {
+        undo_encemit(undo_litcount - 1);
+        for (i = 0; i < undo_litcount; i++)
+        {
+            undo_encemit(undo_lit[i]);
+        }
+        undo_litcount = 0;
+    }
+}
+
+static void undo_encrun()
+{
+    // Function to write the present run, as run if long enough, else added to the literals
+
+    if (undo_runcount > 2)
+    {
+        undo_encliterals();
+        undo_encemit(undo_runcount + 126);
+        undo_encemit(undo_runbyte);
+    }
+    else
+    {
+        for (; undo_runcount; undo_runcount--)
+        {
+            undo_lit[undo_litcount++] = undo_runbyte;
+            if (undo_litcount == 128)
+            {
+                undo_encliterals();
+            }
+        }
+    }
+    undo_runcount = 0;
+}
+
+static void undo_encput(char b)
+{
+    // Function to add a byte to the encoded delta
+
+    if (undo_runcount && b == undo_runbyte && undo_runcount < 129)
+    {
+        undo_runcount++;
+        return;
+    }
+    undo_encrun();
+    undo_runbyte = b;
+    undo_runcount = 1;
+}
+
+void undo_commit()
+{
+    // Function to replace the raw before image of the newest undo entry by its delta with the screen map
+    // Keeps the raw entry if there is no room to encode or the delta is not smaller
+
+    struct UndoStruct *entry = &undo_entry;
+    unsigned address, x, y, n, i;
+    char plane;
+
+    if (!undo_pending)
+    {
+        return;
+    }
+    undo_pending = 0;
+    undo_readheader(undo_current);
+
+    // Encode in the free memory after the before image, growing it by eviction when needed
+    address = undo_current + UNDO_HEADER;
+    if ((unsigned long)address + entry->size >= undoend)
+    {
+        return;
+    }
+    undo_encmax = entry->size;
+    undo_encbase = address + undo_encmax;
+    undo_enclimit = undo_freeahead((unsigned long)address + undo_encmax);
+    if (undo_enclimit > undo_encmax)
+    {
+        undo_enclimit = undo_encmax;
+    }
+    undo_enclen = 0;
+    undo_litcount = 0;
+    undo_runcount = 0;
+    for (plane = 0; plane < SCREENMAP_PLANES && undo_enclen <= undo_enclimit; plane++)
+    {
+        for (y = 0; y < entry->height && undo_enclen <= undo_enclimit; y++)
+        {
+            for (x = 0; x < entry->width; x += n)
+            {
+                n = entry->width - x;
+                if (n > UNDO_CHUNK)
+                {
+                    n = UNDO_CHUNK;
+                }
+                undostore_get(BNK_0_FULL, undo_before, address, n);
+                address += n;
+                if (plane)
+                {
+                    bnk_memcpy(BNK_0_FULL, undo_after, BNK_1_FULL, screenmap_attraddr(entry->ystart + y, entry->xstart + x, canvas.sourcewidth, canvas.sourceheight), n);
+                }
+                else
+                {
+                    bnk_memcpy(BNK_0_FULL, undo_after, BNK_1_FULL, screenmap_screenaddr(entry->ystart + y, entry->xstart + x, canvas.sourcewidth), n);
+                }
+                for (i = 0; i < n; i++)
+                {
+                    undo_encput(undo_before[i] ^ undo_after[i]);
+                }
+            }
+        }
+    }
+    undo_encrun();
+    undo_encliterals();
+    if (undo_enclen > undo_enclimit || undo_enclen >= undo_encmax)
+    {
+        return;
+    }
+
+    // Move the delta to the start of the entry and free the rest
+    for (i = 0; i < undo_enclen; i += n)
+    {
+        n = undo_enclen - i;
+        if (n > 255)
+        {
+            n = 255;
+        }
+        undostore_copy(undo_current + UNDO_HEADER + i, undo_encbase + i, n);
+    }
+    entry->delta = 1;
+    entry->size = undo_enclen;
+    undo_writeheader(undo_current);
+    undoaddress = undo_current + UNDO_HEADER + undo_enclen;
+}
+
+static void undo_deltaapply(struct UndoStruct *entry, unsigned address)
+{
+    // Function to apply a delta encoded undo entry to the screen map, switching between before and after image
+
+    unsigned long left = SCREENMAP_DATA_BYTES(entry->width, entry->height) * SCREENMAP_PLANES;
+    unsigned x = 0;
+    unsigned y = 0;
+    char *p = screenmap_screenaddr(entry->ystart, entry->xstart, canvas.sourcewidth);
+    char ctrl, b, n, literal;
+
+    while (left)
+    {
+        ctrl = undostore_read(address++);
+        literal = !(ctrl & 0x80);
+        if (literal)
+        {
+            n = ctrl + 1;
+        }
+        else
+        {
+            n = ctrl - 126;
+            b = undostore_read(address++);
+        }
+        while (n && left)
+        {
+            if (literal)
+            {
+                b = undostore_read(address++);
+            }
+            if (b)
+            {
+                bnk_writeb(BNK_1_FULL, p, bnk_readb(BNK_1_FULL, p) ^ b);
+            }
+            p++;
+            n--;
+            left--;
+
+            // Next row, after the last row continue with the attributes
+            if (++x == entry->width)
+            {
+                x = 0;
+                p += canvas.sourcewidth - entry->width;
+                if (++y == entry->height)
+                {
+                    y = 0;
+                    p = screenmap_attraddr(entry->ystart, entry->xstart, canvas.sourcewidth, canvas.sourceheight);
+                }
+            }
+        }
+    }
+}
+
+static void undo_discardredo()
+{
+    // Function to commit the present entry and discard the redo chain before a new undo entry
+    // The write head returns to the end of the newest undo entry
+
+    undo_commit();
+    if (undo_redopossible > 0)
+    {
+        undo_redopossible = 0;
+        if (undo_undopossible)
+        {
+            undo_readheader(undo_current);
+            undoaddress = undo_current + UNDO_HEADER + undo_entry.size;
+        }
+        else
+        {
+            undoaddress = undostart;
+        }
+    }
+}
+
+static void undo_link(unsigned address)
+{
+    // Function to write the header in undo_entry for a new entry and link it after the present one
+    // The caller sets position, size and type of the entry in undo_entry
+
+    if (undo_undopossible)
+    {
+        undo_setnext(undo_current, address);
+        undo_entry.prev = undo_current;
+    }
+    else
+    {
+        undo_tail = address;
+        undo_entry.prev = 0;
+    }
+    undo_entry.next = 0;
+    undo_entry.redopresent = 0;
+    undo_entry.redoaddress = 0;
+    undo_writeheader(address);
+    undo_current = address;
+    undo_undopossible++;
+    if (UNDO_HEADER + undo_entry.size > undo_stats.largest)
+    {
+        undo_stats.largest = UNDO_HEADER + undo_entry.size;
+    }
+}
+
+// Undo capture from the screen
+// Canvas cells shown on the VDC screen are copied into VDC undo memory with VDC block copies instead of
+// through the CPU. Cells outside the view, under the status bar or under popup windows come from the
+// screen map, as do all cells with layers shown or while undo_screendirty marks a preview on the canvas.
+
+static char undo_screenrow(unsigned row)
+{
+    // Function to check if a canvas row is shown unchanged on the screen
+    // Returns the row in the view plus 1, or 0 if the row has to be read from the screen map
+
+    unsigned viewrow;
+
+    if (undo_banked || undo_screendirty || canvas.compositor || winCfg.active || row < canvas.sourceyoffset)
+    {
+        return 0;
+    }
+    viewrow = row - canvas.sourceyoffset;
+    if (viewrow >= canvas.view.wy || (showbar && canvas.view.sy + viewrow == vdc_state.height - 1))
+    {
+        return 0;
+    }
+    return viewrow + 1;
+}
+
+static void undo_capturemap(unsigned address, unsigned row, unsigned col, unsigned width, unsigned planesize)
+{
+    // Function to copy a part of a canvas row from the screen map to undo memory
+    // planesize: distance of the attribute plane from the code plane in the entry
+
+    undostore_put(address, BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), width);
+    if (!canvasmono)
+    {
+        undostore_put(address + planesize, BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), width);
+    }
+}
+
+static void undo_capturerow(unsigned address, unsigned row, unsigned col, unsigned width, unsigned planesize)
+{
+    // Function to copy a canvas row to undo memory, the part shown on screen with VDC block copies
+
+    unsigned first = col;
+    unsigned last = col;
+    unsigned vdcaddress;
+    char viewrow = undo_screenrow(row);
+
+    // Part of the row within the view
+    if (viewrow)
+    {
+        first = (col > canvas.sourcexoffset) ? col : canvas.sourcexoffset;
+        last = canvas.sourcexoffset + canvas.view.wx;
+        if (last > col + width)
+        {
+            last = col + width;
+        }
+        if (first >= last)
+        {
+            first = col;
+            last = col;
+        }
+    }
+
+    // Left and right of the view from the screen map
+    if (first > col)
+    {
+        undo_capturemap(address, row, col, first - col, planesize);
+    }
+    if (last < col + width)
+    {
+        undo_capturemap(address + (last - col), row, last, col + width - last, planesize);
+    }
+
+    // Shown part from the screen
+    if (last > first)
+    {
+        vdcaddress = vdc_coords(first - canvas.sourcexoffset, viewrow - 1);
+        vdc_block_copy_page(address + (first - col), canvas.view.sp + vdcaddress, last - first);
+        if (!canvasmono)
+        {
+            vdc_block_copy_page(address + planesize + (first - col), canvas.view.cp + vdcaddress, last - first);
+        }
+    }
+}
+
+static char undo_capture(unsigned row, unsigned col, unsigned width, unsigned height)
+{
+    // Function to create a new undo entry with the before image of an area
+    // Only the before image is allocated, redo images are made when the entry is undone
+    // Returns 0 if no memory could be found
+
+    unsigned y, address, data, cursorcol;
+    unsigned long undo_bytes = UNDO_BUFFER_BYTES(width, height);
+
+    undo_discardredo();
+    address = undo_alloc(UNDO_HEADER + undo_bytes, 0);
+    if (!address)
+    {
+        return 0;
+    }
+    data = address + UNDO_HEADER;
+    for (y = 0; y < height; y++)
+    {
+        undo_capturerow(data + (y * width), row + y, col, width, width * height);
+    }
+
+    // The cursor is drawn over its cell on screen
+    y = canvas.sourceyoffset + screen_row;
+    cursorcol = canvas.sourcexoffset + screen_col;
+    if (y >= row && y < row + height && cursorcol >= col && cursorcol < col + width)
+    {
+        undo_capturemap(data + (y - row) * width + (cursorcol - col), y, cursorcol, 1, width * height);
+    }
+    undo_entry.xstart = col;
+    undo_entry.ystart = row;
+    undo_entry.width = width;
+    undo_entry.height = height;
+    undo_entry.delta = 0;
+    undo_entry.size = (unsigned)undo_bytes;
+    undo_link(address);
+    undoaddress = (unsigned)((unsigned long)data + undo_bytes);
+    undo_pending = 1;
+    return 1;
+}
+
+// Undo groups
+// Single cell edits (typing, plotting) are logged per cell with their old values instead of getting an
+// undo entry each. The group becomes one entry over the bounding box of its cells when it is closed:
+// on the next undo action, on undo or redo, on leaving write mode, on a cursor jump or a full log.
+
+void undo_group_close()
+{
+    // Function to turn the open undo group into one undo entry
+    // The captured area already shows the new cells, so the logged old values are written over it
+
+    char i = undo_groupcount;
+    unsigned width, height, offset, address;
+
+    if (!i)
+    {
+        return;
+    }
+    undo_groupcount = 0;
+    width = undo_groupmaxcol - undo_groupmincol + 1;
+    height = undo_groupmaxrow - undo_groupminrow + 1;
+    if (!undo_capture(undo_groupminrow, undo_groupmincol, width, height))
+    {
+        return;
+    }
+    address = undo_current + UNDO_HEADER;
+
+    // Newest first, so a cell changed more than once ends with its oldest value
+    while (i)
+    {
+        i--;
+        offset = (undo_grouprow[i] - undo_groupminrow) * width + undo_groupcol[i] - undo_groupmincol;
+        undostore_write(address + offset, undo_groupcode[i]);
+        if (!canvasmono)
+        {
+            undostore_write(address + (width * height) + offset, undo_groupattr[i]);
+        }
+    }
+}
+
+void undo_group_cell(unsigned row, unsigned col)
+{
+    // Function to log a cell that is about to change in the undo group
+    // A cell not next to the previous one is a cursor jump and starts a new group
+
+    char n = undo_groupcount;
+
+    if (n && (n == UNDO_GROUP_MAX || row + 1 < undo_grouprow[n - 1] || row > undo_grouprow[n - 1] + 1 || col + 1 < undo_groupcol[n - 1] || col > undo_groupcol[n - 1] + 1))
+    {
+        undo_group_close();
+        n = 0;
+    }
+    if (!n)
+    {
+        // The pending entry is encoded against the map before the first group cell changes
+        undo_discardredo();
+        undo_groupminrow = undo_groupmaxrow = row;
+        undo_groupmincol = undo_groupmaxcol = col;
+    }
+    if (row < undo_groupminrow)
+    {
+        undo_groupminrow = row;
+    }
+    if (row > undo_groupmaxrow)
+    {
+        undo_groupmaxrow = row;
+    }
+    if (col < undo_groupmincol)
+    {
+        undo_groupmincol = col;
+    }
+    if (col > undo_groupmaxcol)
+    {
+        undo_groupmaxcol = col;
+    }
+    undo_grouprow[n] = row;
+    undo_groupcol[n] = col;
+    undo_groupcode[n] = bnk_readb(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth));
+    undo_groupattr[n] = screenmap_readattr(row, col);
+    undo_groupcount = n + 1;
+}
+
+void undo_new(unsigned row, unsigned col, unsigned width, unsigned height)
+{
+    // Function to create a new undo buffer position
+
+    undo_group_close();
+    undo_capture(row, col, width, height);
+    screenmap_dirty(row, col, width, height);
+}
+
+// Charset entries
+// Loading a charset stores the charset it replaces as an entry of type UNDO_CHARSET, xstart holds
+// standard (0) or alternate (1). Undo and redo swap the entry data with the charset in Bank 1.
+
+void undo_charset(char stdoralt)
+{
+    // Function to create an undo entry with a copy of a charset before it is replaced
+
+    unsigned address;
+
+    undo_group_close();
+    undo_discardredo();
+    address = undo_alloc(UNDO_HEADER + UNDO_CHARSET_BYTES, 0);
+    if (!address)
+    {
+        return;
+    }
+    undostore_put(address + UNDO_HEADER, BNK_1_FULL, (char *)(stdoralt ? CHARSETALTERNATE : CHARSETNORMAL), UNDO_CHARSET_BYTES);
+    undo_entry.xstart = stdoralt;
+    undo_entry.ystart = 0;
+    undo_entry.width = 0;
+    undo_entry.height = 0;
+    undo_entry.delta = UNDO_CHARSET;
+    undo_entry.size = UNDO_CHARSET_BYTES;
+    undo_link(address);
+    undoaddress = address + UNDO_HEADER + UNDO_CHARSET_BYTES;
+}
+
+static void undo_charsetswap(struct UndoStruct *entry, unsigned address)
+{
+    // Function to swap the charset stored in a charset entry with the charset in Bank 1
+
+    char *charset = (char *)(entry->xstart ? CHARSETALTERNATE : CHARSETNORMAL);
+    unsigned i, n;
+
+    for (i = 0; i < UNDO_CHARSET_BYTES; i += n)
+    {
+        n = UNDO_CHARSET_BYTES - i;
+        if (n > UNDO_CHUNK)
+        {
+            n = UNDO_CHUNK;
+        }
+        undostore_get(BNK_0_FULL, undo_before, address + i, n);
+        bnk_memcpy(BNK_0_FULL, undo_after, BNK_1_FULL, charset + i, n);
+        bnk_memcpy(BNK_1_FULL, charset + i, BNK_0_FULL, undo_before, n);
+        undostore_put(address + i, BNK_0_FULL, undo_after, n);
+    }
+    bnk_redef_charset(entry->xstart ? vdc_state.char_alt : vdc_state.char_std, BNK_1_FULL, charset, 256);
+    charsetchanged[entry->xstart] = 1;
+    charundo_clear();
+}
+
+// Move entries
+// A move mode shift of the view area is stored as its net shift x and y, the furthest shifts left and up
+// and the furthest shifts right and down (UNDO_MOVE_PARAMS signed chars), followed by the strips of cells these pushed off the
+// edges: left, right, top and bottom. Undo shifts back and restores the strips, redo shifts again and
+// clears the cells that were pushed in.
+
+static unsigned undo_moverect(unsigned address, unsigned row, unsigned col, unsigned width, unsigned height, char capture)
+{
+    // Function to copy an area of the screen map to an undo entry (capture 1) or back (capture 0)
+    // Returns the entry address after the area
+
+    unsigned y;
+    char plane;
+    char *p;
+
+    if (!width || !height)
+    {
+        return address;
+    }
+    for (plane = 0; plane < SCREENMAP_PLANES; plane++)
+    {
+        for (y = 0; y < height; y++)
+        {
+            p = (plane) ? screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight) : screenmap_screenaddr(row + y, col, canvas.sourcewidth);
+            if (capture)
+            {
+                undostore_put(address, BNK_1_FULL, p, width);
+            }
+            else
+            {
+                undostore_get(BNK_1_FULL, p, address, width);
+            }
+            address += width;
+        }
+    }
+    return address;
+}
+
+static unsigned undo_movestrips(unsigned address, struct UndoStruct *entry, signed char *params, char capture)
+{
+    // Function to copy the strips pushed off by a move between the screen map and an undo entry
+    // Returns the entry address after the strips
+
+    unsigned row = entry->ystart;
+    unsigned col = entry->xstart;
+    unsigned width = entry->width;
+    unsigned height = entry->height;
+    unsigned right = params[4];
+    unsigned bottom = params[5];
+
+    address = undo_moverect(address, row, col, -params[2], height, capture);
+    address = undo_moverect(address, row, col + width - right, right, height, capture);
+    address = undo_moverect(address, row, col, width, -params[3], capture);
+    return undo_moverect(address, row + height - bottom, col, width, bottom, capture);
+}
+
+static void undo_moveshift(struct UndoStruct *entry, int dx, int dy)
+{
+    // Function to shift the content of the area of a move entry in the screen map, cells shifted out are lost
+
+    unsigned width = entry->width;
+    unsigned height = entry->height;
+    unsigned len, y, source;
+    unsigned scol = (dx < 0) ? -dx : 0;
+    unsigned dcol = (dx > 0) ? dx : 0;
+    char plane;
+    char *sp, *dp;
+
+    if ((unsigned)abs(dx) >= width || (unsigned)abs(dy) >= height)
+    {
+        return;
+    }
+    len = width - abs(dx);
+
+    // Rows in the order that does not overwrite rows still to be read
+    for (plane = 0; plane < SCREENMAP_PLANES; plane++)
+    {
+        for (y = 0; y < height - abs(dy); y++)
+        {
+            source = (dy > 0) ? height - dy - 1 - y : y - dy;
+            if (plane)
+            {
+                sp = screenmap_attraddr(entry->ystart + source, entry->xstart + scol, canvas.sourcewidth, canvas.sourceheight);
+                dp = screenmap_attraddr(entry->ystart + source + dy, entry->xstart + dcol, canvas.sourcewidth, canvas.sourceheight);
+            }
+            else
+            {
+                sp = screenmap_screenaddr(entry->ystart + source, entry->xstart + scol, canvas.sourcewidth);
+                dp = screenmap_screenaddr(entry->ystart + source + dy, entry->xstart + dcol, canvas.sourcewidth);
+            }
+            bnk_memcpy(BNK_0_FULL, undo_before, BNK_1_FULL, sp, len);
+            bnk_memcpy(BNK_1_FULL, dp, BNK_0_FULL, undo_before, len);
+        }
+    }
+}
+
+static void undo_moveclear(struct UndoStruct *entry, int row, int col, int width, int height)
+{
+    // Function to clear a part of the area of a move entry with spaces in white, clipped to the area
+
+    int y;
+
+    if (col < 0)
+    {
+        width += col;
+        col = 0;
+    }
+    if (row < 0)
+    {
+        height += row;
+        row = 0;
+    }
+    if (col + width > (int)entry->width)
+    {
+        width = entry->width - col;
+    }
+    if (row + height > (int)entry->height)
+    {
+        height = entry->height - row;
+    }
+    if (width <= 0)
+    {
+        return;
+    }
+    for (y = 0; y < height; y++)
+    {
+        bnk_memset(BNK_1_FULL, screenmap_screenaddr(entry->ystart + row + y, entry->xstart + col, canvas.sourcewidth), CH_SPACE, width);
+        if (!canvasmono)
+        {
+            bnk_memset(BNK_1_FULL, screenmap_attraddr(entry->ystart + row + y, entry->xstart + col, canvas.sourcewidth, canvas.sourceheight), VDC_WHITE, width);
+        }
+    }
+}
+
+void undo_move(unsigned row, unsigned col, unsigned width, unsigned height, signed char *params)
+{
+    // Function to create an undo entry for a move mode shift before it is written to the screen map
+    // params: net shift x and y, furthest shift left and up (negative), right and down, limited to the area size
+
+    unsigned address, strips;
+    char i;
+
+    undo_group_close();
+    undo_discardredo();
+    strips = (unsigned)((params[4] - params[2]) * height + (params[5] - params[3]) * width) * SCREENMAP_PLANES;
+    address = undo_alloc(UNDO_HEADER + UNDO_MOVE_PARAMS + strips, 0);
+    if (!address)
+    {
+        return;
+    }
+    undo_entry.xstart = col;
+    undo_entry.ystart = row;
+    undo_entry.width = width;
+    undo_entry.height = height;
+    undo_entry.delta = UNDO_MOVE;
+    undo_entry.size = UNDO_MOVE_PARAMS + strips;
+    for (i = 0; i < UNDO_MOVE_PARAMS; i++)
+    {
+        undostore_write(address + UNDO_HEADER + i, params[i]);
+    }
+    undo_movestrips(address + UNDO_HEADER + UNDO_MOVE_PARAMS, &undo_entry, params, 1);
+    undo_link(address);
+    undoaddress = address + UNDO_HEADER + undo_entry.size;
+}
+
+static void undo_moveapply(struct UndoStruct *entry, unsigned address, char redo)
+{
+    // Function to undo or redo a move entry
+
+    signed char params[UNDO_MOVE_PARAMS];
+    char i;
+
+    for (i = 0; i < UNDO_MOVE_PARAMS; i++)
+    {
+        params[i] = undostore_read(address + i);
+    }
+    if (redo)
+    {
+        undo_moveshift(entry, params[0], params[1]);
+        undo_moveclear(entry, 0, 0, params[0] - params[2], entry->height);
+        undo_moveclear(entry, 0, entry->width - params[4] + params[0], params[4] - params[0], entry->height);
+        undo_moveclear(entry, 0, 0, entry->width, params[1] - params[3]);
+        undo_moveclear(entry, entry->height - params[5] + params[1], 0, entry->width, params[5] - params[1]);
+    }
+    else
+    {
+        undo_moveshift(entry, -params[0], -params[1]);
+        undo_movestrips(address + UNDO_MOVE_PARAMS, entry, params, 0);
+    }
+}
+
+void undo_escapeundo()
+{
+    // Function to cancel an undo slot after escape is pressed in selectmode or movemode
+
+    // Nothing to cancel if no entry was made
+    if (undo_pending && undo_undopossible > 0)
+    {
+        undo_readheader(undo_current);
+        undoaddress = undo_current;
+        undo_current = undo_entry.prev;
+        undo_undopossible--;
+    }
+    undo_pending = 0;
+    plotcursor();
+}
+
+void undo_clear()
+{
+    // Function to reset the undo system
+    // The undo area in VDC memory starts above the cached screens of the project
+    // Without 64 KiB VDC memory the undo area is the Bank 1 memory after the screen map
+
+    undo_banked = (vdc_state.memsize != 64);
+    if (undo_banked)
+    {
+        undostart = SCREENMAPBASE + (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight);
+        undoend = MEMORYLIMIT;
+    }
+    else
+    {
+        undostart = vdc_state.extended;
+        if (screencount > 1)
+        {
+            undostart += (unsigned)(screencount * SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight));
+        }
+        undoend = 0x10000UL;
+    }
+    undoaddress = undostart;
+    undo_pending = 0;
+    undo_groupcount = 0;
+    undo_tail = 0;
+    undo_current = 0;
+    undo_undopossible = 0;
+    undo_redopossible = 0;
+    memset(&undo_stats, 0, sizeof(struct UndoStatsStruct));
+    undo_stats_update();
+}
+
+// Functions for loading a saved undo history
+// The filename.undo file is opened once no screen rows are pending, the main loop loads an entry at a time
+// while idle. Any key other than a cursor key first loads the rest, as the history must be complete.
+
+static void undoload_stop(char keep)
+{
+    // Function to close the undo history file, clearing the history if not completely loaded
+
+    krnio_close(BNK_STREAM_FNUM);
+    undoload_pending = 0;
+    if (!keep)
+    {
+        undo_clear();
+    }
+}
+
+static char undoload_entry()
+{
+    // Function to open the undo history file or load its next entry
+    // Returns 0 when loading has ended
+
+    char header[UNDO_FILE_HEADER];
+    unsigned address, size, i, n;
+
+    if (undoload_pending == 1)
+    {
+        // Only use a history of the same canvas size and colour mode
+        sprintf(linebuffer, "%s.undo,p,r", filename);
+        krnio_setbnk(0, 0);
+        krnio_setnam(linebuffer);
+        undoload_pending = 0;
+        if (!krnio_open(BNK_STREAM_FNUM, targetdevice, 2))
+        {
+            return 0;
+        }
+        undoload_pending = 2;
+        if (krnio_read(BNK_STREAM_FNUM, header, UNDO_FILE_HEADER) != UNDO_FILE_HEADER ||
+            header[0] != UNDO_FILE_MAGIC0 || header[1] != UNDO_FILE_MAGIC1 || header[2] != UNDO_FILE_FORMAT ||
+            ((unsigned char)header[3] | ((unsigned)header[4] << 8)) != canvas.sourcewidth ||
+            ((unsigned char)header[5] | ((unsigned)header[6] << 8)) != canvas.sourceheight ||
+            header[7] != (char)SCREENMAP_PLANES)
+        {
+            undoload_stop(1);
+            return 0;
+        }
+        undoload_count = (unsigned char)header[8] | ((unsigned)header[9] << 8);
+        return 1;
+    }
+
+    if (!undoload_count)
+    {
+        undoload_stop(1);
+        return 0;
+    }
+
+    // Entry header of position, size, type and data size, then the data run length encoded in chunks
+    if (krnio_read(BNK_STREAM_FNUM, header, UNDO_FILE_ENTRY) != UNDO_FILE_ENTRY)
+    {
+        undoload_stop(0);
+        return 0;
+    }
+    size = (unsigned char)header[9] | ((unsigned)header[10] << 8);
+    address = undo_alloc(UNDO_HEADER + (unsigned long)size, 0);
+    if (!address)
+    {
+        undoload_stop(0);
+        return 0;
+    }
+    for (i = 0; i < size; i += n)
+    {
+        n = (size - i > UNDO_CHUNK) ? UNDO_CHUNK : size - i;
+        if (bnk_io_read_rle(BNK_STREAM_FNUM, BNK_0_FULL, undo_before, n) != n)
+        {
+            undoload_stop(0);
+            return 0;
+        }
+        undostore_put(address + UNDO_HEADER + i, BNK_0_FULL, undo_before, n);
+    }
+    undo_entry.ystart = (unsigned char)header[0] | ((unsigned)header[1] << 8);
+    undo_entry.xstart = (unsigned char)header[2] | ((unsigned)header[3] << 8);
+    undo_entry.height = (unsigned char)header[4] | ((unsigned)header[5] << 8);
+    undo_entry.width = (unsigned char)header[6] | ((unsigned)header[7] << 8);
+    undo_entry.delta = header[8];
+    undo_entry.size = size;
+    undo_link(address);
+    undoaddress = address + UNDO_HEADER + size;
+    undoload_count--;
+    return 1;
+}
+
+void undoload_finish()
+{
+    // Function to load the rest of the undo history, needed before the history or the disk is used
+
+    screenload_finish();
+    while (undoload_pending && undoload_entry())
+    {
+    }
+}
+
+// Functions for multiple screens per project
+// All screens share canvas size and charsets. The screen being edited lives in the Bank 1 screen map,
+// each screen has a cache slot in the spare VDC memory above vdc_state.extended.
+
+unsigned screens_slotaddress(char screen)
+{
+    // Function to calculate the VDC address of the cache slot of a screen
+
+    return vdc_state.extended + (unsigned)(screen * SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight));
+}
+
+char screens_maxcount()
+{
+    // Function to calculate the number of screens fitting in VDC memory
+    // Room for one full canvas undo is kept free
+
+    unsigned long spare;
+    unsigned long count;
+
+    if (vdc_state.memsize != 64)
+    {
+        return 1;
+    }
+    spare = 0x10000UL - vdc_state.extended - (SCREENMAP_DATA_BYTES(canvas.sourcewidth, canvas.sourceheight) * SCREENMAP_PLANES);
+    if (spare > 0x10000UL)
+    {
+        return 1;
+    }
+    count = spare / SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight);
+    if (count < 1)
+    {
+        return 1;
+    }
+    return (count > SCREENS_MAX) ? SCREENS_MAX : (char)count;
+}
+
+char screens_single()
+{
+    // Function to check that the project has a single screen, shows message if not
+    // Used for operations changing the canvas layout
+
+    if (screencount > 1)
+    {
+        menu_messagepopup("Not with multiple screens.");
+        return 0;
+    }
+    return 1;
+}
+
+void screens_store()
+{
+    // Function to store the screen being edited in its VDC cache slot
+
+    bnk_cpytovdc(screens_slotaddress(screencurrent), BNK_1_FULL, (char *)SCREENMAPBASE, (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight));
+}
+
+void screens_fetch(char screen)
+{
+    // Function to copy a screen from its VDC cache slot to the Bank 1 screen map
+
+    cursor_cached = 0;
+    bnk_cpyfromvdc(BNK_1_FULL, (char *)SCREENMAPBASE, screens_slotaddress(screen), (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight));
+}
+
+void updatecanvas_title()
+// Update the menu titles for the screen number and layers
+{
+    sprintf(pulldown_titles[1][4], "Screen: %u of %u ", screencurrent + 1, screencount);
+    sprintf(pulldown_titles[VDC_MENU_SCREENS][3], "Layers:  %s", layershow ? "On " : "Off");
+    sprintf(pulldown_titles[VDC_MENU_SCREENS][4], "Visible: %s", (layerhidden & (1U << screencurrent)) ? "No " : "Yes");
+    sprintf(pulldown_titles[VDC_MENU_SCREENS][5], "Transp.: $%02X", layertransparent);
+}
+
+void screens_switch(char screen)
+{
+    // Function to switch to another screen of the project
+
+    if (screen == screencurrent || screen >= screencount)
+    {
+        return;
+    }
+
+    hidecursor();
+    screens_store();
+    screens_fetch(screen);
+    screencurrent = screen;
+    undo_clear();
+    updatecanvas_title();
+    vdcwin_cpy_viewport(&canvas);
+    if (showbar)
+    {
+        initstatusbar();
+    }
+    plotcursor();
+}
+
+// Functions for layers
+// With layers shown, the screens of the project are composited on the canvas view from screen 1 (bottom)
+// upwards. Cells with the transparent screencode show the layers below. The edited screen is always shown,
+// its data is read from the Bank 1 screen map, the other screens from their VDC cache slots.
+
+void layers_readrow(char screen, unsigned row, unsigned col, char width)
+{
+    // Function to read part of a row of a screen in the layer source buffers
+
+    unsigned address;
+
+    if (screen == screencurrent)
+    {
+        bnk_memcpy(BNK_0_FULL, layerrow_srcchars, BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), width);
+        if (!canvasmono)
+        {
+            bnk_memcpy(BNK_0_FULL, layerrow_srcattrs, BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), width);
+        }
+        return;
+    }
+
+    address = screens_slotaddress(screen) + (row * canvas.sourcewidth) + col;
+    bnk_cpyfromvdc(BNK_0_FULL, layerrow_srcchars, address, width);
+    if (!canvasmono)
+    {
+        bnk_cpyfromvdc(BNK_0_FULL, layerrow_srcattrs, address + screentotal + 48, width);
+    }
+}
+
+void layers_row(unsigned row, unsigned col, char width)
+{
+    // Function to composite part of a row of all shown layers in the layer row buffers
+
+    char screen, x;
+    char first = 1;
+
+    for (screen = 0; screen < screencount; screen++)
+    {
+        if (screen != screencurrent && (layerhidden & (1U << screen)))
+        {
+            continue;
+        }
+
+        layers_readrow(screen, row, col, width);
+        if (first)
+        {
+            memcpy(layerrow_chars, layerrow_srcchars, width);
+            memcpy(layerrow_attrs, layerrow_srcattrs, width);
+            first = 0;
+        }
+        else
+        {
+            for (x = 0; x < width; x++)
+            {
+                if (layerrow_srcchars[x] != layertransparent)
+                {
+                    layerrow_chars[x] = layerrow_srcchars[x];
+                    layerrow_attrs[x] = layerrow_srcattrs[x];
+                }
+            }
+        }
+    }
+}
+
+void layers_plotcell(char x, char y, char screencode, char attribute)
+{
+    // Function to draw a cell of the canvas view showing the given cell on the edited screen, for cells drawn
+    // before or without writing them to the screen map. With layers shown the cell is composited with the other
+    // shown layers, so a transparent screencode shows the layers below
+
+    unsigned row = canvas.sourceyoffset + y;
+    unsigned col = canvas.sourcexoffset + x;
+    char screen;
+    char first = 1;
+    char ch = screencode;
+    char attr = attribute;
+
+    if (canvas.compositor)
+    {
+        for (screen = 0; screen < screencount; screen++)
+        {
+            if (screen != screencurrent && (layerhidden & (1U << screen)))
+            {
+                continue;
+            }
+            if (screen != screencurrent)
+            {
+                layers_readrow(screen, row, col, 1);
+            }
+            else
+            {
+                layerrow_srcchars[0] = screencode;
+                layerrow_srcattrs[0] = attribute;
+            }
+            if (first || layerrow_srcchars[0] != layertransparent)
+            {
+                ch = layerrow_srcchars[0];
+                attr = layerrow_srcattrs[0];
+                first = 0;
+            }
+        }
+        if (canvasmono)
+        {
+            attr = monocolor;
+        }
+    }
+    vdc_printc(x, y, ch, attr);
+}
+
+void layers_composite(struct VDCViewport *vp)
+{
+    // Compositor of the canvas viewport: draw the view area from all shown layers
+    // Also called for the parts of the view to update on scrolling and cursor moves
+
+    unsigned textbase = vp->view.sp;
+    unsigned attrbase = vp->view.cp;
+    char y;
+
+    for (y = 0; y < vp->view.wy; y++)
+    {
+        layers_row(vp->sourceyoffset + y, vp->sourcexoffset, vp->view.wx);
+        bnk_cpytovdc(textbase, BNK_0_FULL, layerrow_chars, vp->view.wx);
+        if (vp->sourcemono)
+        {
+            vdc_block_fill(attrbase, vp->monoattr, vp->view.wx - 1);
+        }
+        else
+        {
+            bnk_cpytovdc(attrbase, BNK_0_FULL, layerrow_attrs, vp->view.wx);
+        }
+        textbase += VDC_ROWSTRIDE;
+        attrbase += VDC_ROWSTRIDE;
+    }
+}
+
+void layers_update()
+{
+    // Function to set the layer compositor of the canvas if layers are shown
+
+    if (layershow && screencount > 1)
+    {
+        vdcwin_viewport_compositor(&canvas, layers_composite);
+    }
+    else
+    {
+        vdcwin_viewport_compositor(&canvas, NULL);
+    }
+}
+
+char layers_flatten()
+{
+    // Function to flatten all shown layers in the Bank 1 screen map before saving or exporting
+    // Returns 1 if flattened: restore the edited screen afterwards with screens_fetch(screencurrent)
+
+    unsigned row, col;
+    char width;
+
+    if (!canvas.compositor)
+    {
+        return 0;
+    }
+
+    screens_store();
+    for (row = 0; row < canvas.sourceheight; row++)
+    {
+        for (col = 0; col < canvas.sourcewidth; col += width)
+        {
+            width = (canvas.sourcewidth - col > LAYER_ROWMAX) ? LAYER_ROWMAX : canvas.sourcewidth - col;
+            layers_row(row, col, width);
+            bnk_memcpy(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), BNK_0_FULL, layerrow_chars, width);
+            if (!canvasmono)
+            {
+                bnk_memcpy(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), BNK_0_FULL, layerrow_attrs, width);
+            }
+        }
+    }
+    return 1;
+}
+
+// Help screens
+void helpscreen_load(char screennumber)
+{
+    char oldmode = vdc_state.mode;
+
+    // Function to show selected help screen
+    // Input: screennumber: 1-Main mode, 2-Character editor, 3-SelectMoveLinebox, 4-Write/colorwrite mode
+
+    hidecursor();
+
+    // Load system charset if needed
+    if (charsetchanged[1] == 1)
+    {
+        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETSYSTEM, 256);
+    }
+
+    // Set background color to black and switch cursor off
+    vdc_bgcolor(VDC_BLACK);
+
+    // Set standard text mode if needed, the help screens are loaded as one block
+    hwscroll_exit();
+    if (oldmode)
+    {
+        vdc_set_mode(0);
+    }
+
+    // Load selected help screen
+    sprintf(buffer, "vdcsehsc%u", screennumber);
+
+    if (bnk_load(bootdevice, 1, (char *)WINDOWBASEADDRESS, buffer))
+    {
+        bnk_cpytovdc(vdc_state.base_text, BNK_1_FULL, (char *)WINDOWBASEADDRESS, 4048);
+    }
+    else
+    {
+        menu_messagepopup("Insert application disk to view help.");
+    }
+
+    getch();
+
+    // Restore screen
+    if (oldmode)
+    {
+        vdc_set_mode(oldmode);
+    }
+    hwscroll_init();
+    vdc_bgcolor(screenbackground);
+    vdcwin_cpy_viewport(&canvas);
+    if (splitview)
+    {
+        split_redraw();
+    }
+    if (showbar)
+    {
+        initstatusbar();
+    }
+    if (screennumber != 2)
+    {
+        resetcursor();
+    }
+
+    // Restore custom charset if needed
+    if (charsetchanged[1] == 1)
+    {
+        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, 256);
+    }
+}
+
+// Application routines
+
+void loadsyscharset()
+// Load system charset if needed
+{
+    if (charsetchanged[1] == 1)
+    {
+        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETSYSTEM, 256);
+    }
+}
+
+void restorealtcharset()
+// Restore custom charset if needed
+{
+    if (charsetchanged[1] == 1)
+    {
+        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, 256);
+    }
+}
+
+void plotmove(char direction)
+// Drive cursor move
+// Input: ASCII code of cursor key pressed
+{
+    hidecursor();
+
+    switch (direction)
+    {
+    case CH_CURS_LEFT:
+        cursormove(1, 0, 0, 0);
+        break;
+
+    case CH_CURS_RIGHT:
+        cursormove(0, 1, 0, 0);
+        break;
+
+    case CH_CURS_UP:
+        cursormove(0, 0, 1, 0);
+        break;
+
+    case CH_CURS_DOWN:
+        cursormove(0, 0, 0, 1);
+        break;
+
+    default:
+        break;
+    }
+
+    // The new cell shows the screen map until the cursor is drawn over it
+    cursor_cache();
+    plotcursor();
+}
+
+unsigned canvas_offsetfor(unsigned pos, unsigned offset, char max)
+{
+    // Function to return the view offset closest to the present one that shows a canvas position
+    // Input: position, present view offset and last coordinate of the view on that axis
+
+    if (pos < offset)
+    {
+        return pos;
+    }
+    if (pos > offset + max)
+    {
+        return pos - max;
+    }
+    return offset;
+}
+
+void canvas_viewto(unsigned xoffset, unsigned yoffset, unsigned x, unsigned y)
+{
+    // Function to set the view offsets and the cursor position in one go, with a single redraw of the view
+    // Input: new view offsets and the new cursor position on the canvas, which has to be in the new view
+
+    char oldrow = screen_row;
+
+    hidecursor();
+    screen_col = x - xoffset;
+    screen_row = y - yoffset;
+    vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
+
+    // Cursor move within the view only needs the status bar to give way
+    if (xoffset == canvas.sourcexoffset && yoffset == canvas.sourceyoffset)
+    {
+        if (showbar && oldrow != screen_row)
+        {
+            if (screen_row == vdc_state.height - 1)
+            {
+                hidestatusbar();
+            }
+            else if (oldrow == vdc_state.height - 1)
+            {
+                initstatusbar();
+            }
+        }
+        plotcursor();
+        return;
+    }
+
+    canvas.sourcexoffset = xoffset;
+    canvas.sourceyoffset = yoffset;
+    vdcwin_cpy_viewport(&canvas);
+    if (showbar)
+    {
+        initstatusbar();
+    }
+    plotcursor();
+}
+
+char plotmove_nextkey()
+{
+    // Function to take the next key from the keyboard buffer if it is a cursor key
+    // Returns 0 if the buffer is empty or starts with another key, which is left for the main loop
+
+    if (!*(volatile char *)KEYBUFFERCOUNT)
+    {
+        return 0;
+    }
+
+    switch (*(volatile char *)KEYBUFFER)
+    {
+    case CH_CURS_LEFT:
+    case CH_CURS_RIGHT:
+    case CH_CURS_UP:
+    case CH_CURS_DOWN:
+        return vdcwin_checkch();
+
+    default:
+        return 0;
+    }
+}
+
+void plotmove_repeat(char key)
+// Drive cursor move for a cursor key and the cursor keys waiting behind it
+// Moves scrolling less than SCROLL_JUMP_MIN positions are made step by step, larger ones as one jump
+// with a single redraw of the view, so a held key does not lag behind the key repeat
+// Input: ASCII code of cursor key pressed
+{
+    unsigned x = canvas.sourcexoffset + screen_col;
+    unsigned y = canvas.sourceyoffset + screen_row;
+    unsigned xoffset = canvas.sourcexoffset;
+    unsigned yoffset = canvas.sourceyoffset;
+    unsigned steps;
+
+    // Sum up the moves within the canvas
+    do
+    {
+        switch (key)
+        {
+        case CH_CURS_LEFT:
+            if (x > 0)
+            {
+                x--;
+            }
+            break;
+
+        case CH_CURS_RIGHT:
+            if (x < canvas.sourcewidth - 1)
+            {
+                x++;
+            }
+            break;
+
+        case CH_CURS_UP:
+            if (y > 0)
+            {
+                y--;
+            }
+            break;
+
+        case CH_CURS_DOWN:
+            if (y < canvas.sourceheight - 1)
+            {
+                y++;
+            }
+            break;
+
+        default:
+            break;
+        }
+        key = plotmove_nextkey();
+    } while (key);
+
+    // View offsets bringing the new position in view
+    xoffset = canvas_offsetfor(x, xoffset, getmaxx());
+    yoffset = canvas_offsetfor(y, yoffset, getmaxy());
+    steps = (xoffset > canvas.sourcexoffset) ? xoffset - canvas.sourcexoffset : canvas.sourcexoffset - xoffset;
+    steps += (yoffset > canvas.sourceyoffset) ? yoffset - canvas.sourceyoffset : canvas.sourceyoffset - yoffset;
+
+    // Rows of a partially loaded screen down to the one below the new view
+    if (screenload_pending)
+    {
+        screenload_rows(yoffset + getmaxy() + 2);
+    }
+
+    // Small moves step by step
+    if (steps < SCROLL_JUMP_MIN)
+    {
+        while (canvas.sourcexoffset + screen_col != x)
+        {
+            plotmove((canvas.sourcexoffset + screen_col > x) ? CH_CURS_LEFT : CH_CURS_RIGHT);
+        }
+        while (canvas.sourceyoffset + screen_row != y)
+        {
+            plotmove((canvas.sourceyoffset + screen_row > y) ? CH_CURS_UP : CH_CURS_DOWN);
+        }
+        return;
+    }
+
+    // Large moves as one jump
+    canvas_viewto(xoffset, yoffset, x, y);
+}
+
+void canvas_navigate(char key)
+{
+    // Function to jump the view a page or to the canvas edges
+    // Input: HOME for the upper left corner, CLR for the lower right corner, F3/F5 for a page up/down,
+    //        F2/F4 for a page left/right or F7 followed by a cursor key for the edge in that direction
+
+    unsigned maxxoffset = canvas.sourcewidth - canvas.view.wx;
+    unsigned maxyoffset = canvas.sourceheight - canvas.view.wy;
+    unsigned xoffset = canvas.sourcexoffset;
+    unsigned yoffset = canvas.sourceyoffset;
+    unsigned x = xoffset + screen_col;
+    unsigned y = yoffset + screen_row;
+
+    switch (key)
+    {
+    // Edge in the direction of the cursor key pressed after F7
+    case CH_F7:
+        switch (vdcwin_getch())
+        {
+        case CH_CURS_LEFT:
+            x = 0;
+            xoffset = 0;
+            break;
+
+        case CH_CURS_RIGHT:
+            x = canvas.sourcewidth - 1;
+            xoffset = maxxoffset;
+            break;
+
+        case CH_CURS_UP:
+            y = 0;
+            yoffset = 0;
+            break;
+
+        case CH_CURS_DOWN:
+            y = canvas.sourceheight - 1;
+            yoffset = maxyoffset;
+            break;
+
+        default:
+            return;
+        }
+        break;
+
+    // Upper left and lower right corner
+    case CH_HOME:
+        x = 0;
+        y = 0;
+        xoffset = 0;
+        yoffset = 0;
+        break;
+
+    case CH_CLEAR:
+        x = canvas.sourcewidth - 1;
+        y = canvas.sourceheight - 1;
+        xoffset = maxxoffset;
+        yoffset = maxyoffset;
+        break;
+
+    // Page up and down, or to the first or last row if the view is already at the edge
+    case CH_F3:
+        yoffset = (yoffset > canvas.view.wy) ? yoffset - canvas.view.wy : 0;
+        y = (yoffset == canvas.sourceyoffset) ? 0 : yoffset + screen_row;
+        break;
+
+    case CH_F5:
+        yoffset = (yoffset + canvas.view.wy < maxyoffset) ? yoffset + canvas.view.wy : maxyoffset;
+        y = (yoffset == canvas.sourceyoffset) ? canvas.sourceheight - 1 : yoffset + screen_row;
+        break;
+
+    // Page left and right, or to the first or last column if the view is already at the edge
+    case CH_F2:
+        xoffset = (xoffset > canvas.view.wx) ? xoffset - canvas.view.wx : 0;
+        x = (xoffset == canvas.sourcexoffset) ? 0 : xoffset + screen_col;
+        break;
+
+    case CH_F4:
+        xoffset = (xoffset + canvas.view.wx < maxxoffset) ? xoffset + canvas.view.wx : maxxoffset;
+        x = (xoffset == canvas.sourcexoffset) ? canvas.sourcewidth - 1 : xoffset + screen_col;
+        break;
+
+    default:
+        return;
+    }
+
+    canvas_viewto(xoffset, yoffset, x, y);
+}
+
+void change_plotcolor(char newval)
+// Change the current color to plot in
+// For a mono canvas this is the global colour of the whole canvas
+{
+    plotcolor = newval;
+    vdc_textcolor(newval);
+    if (canvasmono)
+    {
+        monocolor = newval;
+        vdcwin_viewport_mono(&canvas, 1, monocolor);
+        vdcwin_cpy_viewport(&canvas);
+        if (showbar)
+        {
+            initstatusbar();
+        }
+    }
+    plotcursor();
+}
+
+void updatecanvas()
+// Update the menu with the proper screen setting values
+{
+    // A new canvas or screen mode ends the split view
+    splitview = 0;
+    cursor_cached = 0;
+    updatecanvas_title();
+    sprintf(pulldown_titles[0][0], "Width:   %5u ", canvas.sourcewidth);
+    sprintf(pulldown_titles[0][1], "Height:  %5u ", canvas.sourceheight);
+    sprintf(pulldown_titles[0][2], "Background: %2u ", screenbackground);
+    sprintf(pulldown_titles[0][3], "Screenmode: %2u ", vdc_state.mode);
+    sprintf(pulldown_titles[0][6], "Colour:  %s", canvasmono ? "Mono  " : "Full  ");
+    vdcwin_viewport_init(&canvas, BNK_1_FULL, (char *)SCREENMAPBASE, canvas.sourcewidth, canvas.sourceheight, getmaxx() + 1, getmaxy() + 1, 0, 0);
+    vdcwin_viewport_mono(&canvas, canvasmono, monocolor);
+    layers_update();
+    screentotal = canvas.sourcewidth * canvas.sourceheight;
+}
+
+// Canvas resize
+// A resize keeps the cells in the upper left corner. With the undo log in VDC memory it is an undo entry
+// with the old size in width and height, followed by the new size and the cells cut off by shrinking:
+// the part of the rows to the right of the new width, then the rows below the new height.
+// Undo and redo are placed here as undoing a resize needs updatecanvas().
+
+void canvas_resize(unsigned newwidth, unsigned newheight)
+{
+    // Function to change the canvas size, cells outside the new size are lost and new cells are white spaces
+
+    unsigned y;
+
+    if (newwidth < canvas.sourcewidth)
+    {
+        for (y = 1; y < canvas.sourceheight; y++)
+        {
+            screenmap_rowmove(screenmap_screenaddr(y, 0, newwidth), screenmap_screenaddr(y, 0, canvas.sourcewidth), newwidth);
+        }
+        if (!canvasmono)
+        {
+            for (y = 0; y < canvas.sourceheight; y++)
+            {
+                screenmap_rowmove(screenmap_attraddr(y, 0, newwidth, canvas.sourceheight), screenmap_attraddr(y, 0, canvas.sourcewidth, canvas.sourceheight), newwidth);
+            }
+        }
+    }
+    if (newwidth > canvas.sourcewidth)
+    {
+        if (!canvasmono)
+        {
+            for (y = 0; y < canvas.sourceheight; y++)
+            {
+                screenmap_rowmove(screenmap_attraddr(canvas.sourceheight - y - 1, 0, newwidth, canvas.sourceheight), screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
+                bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth, canvas.sourceheight), VDC_WHITE, newwidth - canvas.sourcewidth);
+            }
+        }
+        for (y = 0; y < canvas.sourceheight; y++)
+        {
+            screenmap_rowmove(screenmap_screenaddr(canvas.sourceheight - y - 1, 0, newwidth), screenmap_screenaddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth), canvas.sourcewidth);
+            bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth), CH_SPACE, newwidth - canvas.sourcewidth);
+        }
+    }
+    if (newwidth != canvas.sourcewidth)
+    {
+        canvas.sourcewidth = newwidth;
+        canvas.sourcexoffset = 0;
+        if (screen_col > newwidth - 1)
+        {
+            screen_col = newwidth - 1;
+        }
+    }
+
+    if (newheight < canvas.sourceheight && !canvasmono)
+    {
+        bnk_memcpy(BNK_1_FULL, screenmap_attraddr(0, 0, canvas.sourcewidth, newheight), BNK_1_FULL, screenmap_attraddr(0, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth * canvas.sourceheight);
+    }
+    if (newheight > canvas.sourceheight)
+    {
+        if (!canvasmono)
+        {
+            for (y = 0; y < canvas.sourceheight; y++)
+            {
+                bnk_memcpy(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, newheight), BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
+            }
+            bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight, 0, canvas.sourcewidth, newheight), VDC_WHITE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
+        }
+        bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight, 0, canvas.sourcewidth), CH_SPACE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
+    }
+    if (newheight != canvas.sourceheight)
+    {
+        canvas.sourceheight = newheight;
+        canvas.sourceyoffset = 0;
+        if (screen_row > newheight - 1)
+        {
+            screen_row = newheight - 1;
+        }
+    }
+
+    updatecanvas();
+    placesignature();
+}
+
+void undo_resize(unsigned newwidth, unsigned newheight)
+{
+    // Function to create an undo entry for a canvas resize before it is done
+    // Without room for the entry the older entries would no longer fit the canvas, so they are cleared
+
+    unsigned address, data, keepheight, right, bottom, y;
+    unsigned long strips;
+
+    keepheight = (newheight < canvas.sourceheight) ? newheight : canvas.sourceheight;
+    right = (newwidth < canvas.sourcewidth) ? canvas.sourcewidth - newwidth : 0;
+    bottom = canvas.sourceheight - keepheight;
+    strips = (SCREENMAP_DATA_BYTES(right, keepheight) + SCREENMAP_DATA_BYTES(canvas.sourcewidth, bottom)) * SCREENMAP_PLANES;
+
+    undo_group_close();
+    undo_discardredo();
+    address = undo_alloc(UNDO_HEADER + UNDO_RESIZE_PARAMS + strips, 0);
+    if (!address)
+    {
+        undo_clear();
+        return;
+    }
+    data = address + UNDO_HEADER;
+    undostore_write(data, newwidth & 0xff);
+    undostore_write(data + 1, newwidth >> 8);
+    undostore_write(data + 2, newheight & 0xff);
+    undostore_write(data + 3, newheight >> 8);
+    data += UNDO_RESIZE_PARAMS;
+    for (y = 0; y < keepheight && right; y++)
+    {
+        undo_capturemap(data + (y * right), y, newwidth, right, right * keepheight);
+    }
+    data += (unsigned)(SCREENMAP_DATA_BYTES(right, keepheight) * SCREENMAP_PLANES);
+    for (y = 0; y < bottom; y++)
+    {
+        undo_capturemap(data + (y * canvas.sourcewidth), keepheight + y, 0, canvas.sourcewidth, canvas.sourcewidth * bottom);
+    }
+    undo_entry.xstart = 0;
+    undo_entry.ystart = 0;
+    undo_entry.width = canvas.sourcewidth;
+    undo_entry.height = canvas.sourceheight;
+    undo_entry.delta = UNDO_RESIZE;
+    undo_entry.size = UNDO_RESIZE_PARAMS + (unsigned)strips;
+    undo_link(address);
+    undoaddress = address + UNDO_HEADER + undo_entry.size;
+}
+
+static void undo_restoremap(unsigned address, unsigned row, unsigned col, unsigned width, unsigned planesize)
+{
+    // Function to copy a part of a canvas row from undo memory back to the screen map
+
+    undostore_get(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), address, width);
+    if (!canvasmono)
+    {
+        undostore_get(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), address + planesize, width);
+    }
+}
+
+static void undo_resizeapply(struct UndoStruct *entry, unsigned address, char redo)
+{
+    // Function to undo or redo a resize entry
+
+    unsigned newwidth, newheight, keepheight, right, bottom, y;
+
+    newwidth = undostore_read(address) | ((unsigned)undostore_read(address + 1) << 8);
+    newheight = undostore_read(address + 2) | ((unsigned)undostore_read(address + 3) << 8);
+    if (redo)
+    {
+        canvas_resize(newwidth, newheight);
     }
     else
     {
-        Undo[0].address = 0;
+        keepheight = (newheight < entry->height) ? newheight : entry->height;
+        right = (newwidth < entry->width) ? entry->width - newwidth : 0;
+        bottom = entry->height - keepheight;
+        canvas_resize(entry->width, entry->height);
+        address += UNDO_RESIZE_PARAMS;
+        for (y = 0; y < keepheight && right; y++)
+        {
+            undo_restoremap(address + (y * right), y, newwidth, right, right * keepheight);
+        }
+        address += (unsigned)(SCREENMAP_DATA_BYTES(right, keepheight) * SCREENMAP_PLANES);
+        for (y = 0; y < bottom; y++)
+        {
+            undo_restoremap(address + (y * canvas.sourcewidth), keepheight + y, 0, canvas.sourcewidth, canvas.sourcewidth * bottom);
+        }
+    }
+    vdc_state.text_attr = VDC_WHITE;
+    vdc_cls();
+}
+
+static void undo_redraw(struct UndoStruct *entry)
+{
+    // Function to show the result of an undo or redo: only the area of the entry if it kept the canvas layout
+
+    if (entry->delta == UNDO_MOVE || entry->delta == UNDO_RESIZE)
+    {
+        vdcwin_cpy_viewport(&canvas);
+        view_rect.dirty = 0;
+        if (showbar)
+        {
+            initstatusbar();
+        }
+        return;
     }
-    Undo[undonumber - 1].xstart = col;
-    Undo[undonumber - 1].ystart = row;
-    Undo[undonumber - 1].width = width;
-    Undo[undonumber - 1].height = height;
-    Undo[undonumber - 1].redopresent = redoroompresent;
-    undoaddress = (unsigned)((unsigned long)undoaddress + undo_bytes);
+    canvas_sync();
 }
 
 void undo_performundo()
 {
     // Function to perform an undo if a filled undo slot is present
 
-    unsigned y, row, col, width, height;
+    struct UndoStruct *entry = &undo_entry;
+    unsigned y, row, col, width, height, data;
+
+    undo_commit();
 
     if (undo_undopossible > 0)
     {
-        row = Undo[undonumber - 1].ystart;
-        col = Undo[undonumber - 1].xstart;
-        width = Undo[undonumber - 1].width;
-        height = Undo[undonumber - 1].height;
-        for (y = 0; y < height; y++)
+        undo_readheader(undo_current);
+        data = undo_current + UNDO_HEADER;
+        row = entry->ystart;
+        col = entry->xstart;
+        width = entry->width;
+        height = entry->height;
+
+        // Entries without delta get a redo image of the present area, if memory can be found
+        if (!entry->delta)
         {
-            if (Undo[undonumber - 1].redopresent > 0)
+            entry->redoaddress = undo_alloc(entry->size, 1);
+            entry->redopresent = (entry->redoaddress) ? 1 : 0;
+            if (entry->redopresent)
+            {
+                undoaddress = entry->redoaddress + entry->size;
+            }
+            else
             {
-                bnk_cpytovdc(Undo[undonumber - 1].address + (width * height * 2) + (y * width), BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), width);
-                bnk_cpytovdc(Undo[undonumber - 1].address + (width * height * 3) + (y * width), BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), width);
+                undo_stats.redofailed++;
             }
-            bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), Undo[undonumber - 1].address + (y * width), width);
-            bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), Undo[undonumber - 1].address + (width * height) + (y * width), width);
         }
-        vdcwin_cpy_viewport(&canvas);
-        if (showbar)
+        for (y = 0; y < height && !entry->delta; y++)
         {
-            initstatusbar();
+            if (entry->redopresent)
+            {
+                undostore_put(entry->redoaddress + (y * width), BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), width);
+                if (!canvasmono)
+                {
+                    undostore_put(entry->redoaddress + (width * height) + (y * width), BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), width);
+                }
+            }
+            undostore_get(BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), data + (y * width), width);
+            if (!canvasmono)
+            {
+                undostore_get(BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), data + (width * height) + (y * width), width);
+            }
         }
-        if (Undo[undonumber - 1].redopresent > 0)
+        if (entry->delta == UNDO_CHARSET)
         {
-            Undo[undonumber - 1].redopresent = 2;
-            undo_redopossible++;
+            undo_charsetswap(entry, data);
         }
-        undoaddress = Undo[undonumber - 1].address;
-        undonumber--;
-        if (undonumber == 0)
+        else if (entry->delta == UNDO_MOVE)
         {
-            if (Undo[39].address > 0)
-            {
-                undonumber = 40;
-            }
+            undo_moveapply(entry, data, 0);
         }
-        undo_undopossible--;
-        if (undonumber > 0 && Undo[undonumber - 1].address == 0)
+        else if (entry->delta == UNDO_RESIZE)
         {
-            undo_undopossible = 0;
+            undo_resizeapply(entry, data, 0);
         }
-        if (undonumber == 0 && Undo[39].address == 0)
+        else if (entry->delta)
         {
-            undo_undopossible = 0;
+            undo_deltaapply(entry, data);
         }
-    }
-    plotcursor();
-}
-
-void undo_escapeundo()
-{
-    // Function to cancel an undo slot after escape is pressed in selectmode or movemode
+        undo_writeheader(undo_current);
+        if (entry->delta != UNDO_CHARSET)
+        {
+            screenmap_dirty(row, col, width, height);
+        }
+        undo_redraw(entry);
 
-    Undo[undonumber].address = 0;
-    undonumber--;
-    if (undonumber == 0)
-    {
-        if (Undo[39].address > 0)
+        // An entry without delta or redo image ends the redo chain
+        if (entry->delta || entry->redopresent)
+        {
+            undo_redopossible++;
+        }
+        else
         {
-            undonumber = 40;
+            undo_redopossible = 0;
         }
+        undo_current = entry->prev;
+        undo_undopossible--;
     }
     plotcursor();
 }
@@ -867,178 +3472,57 @@ void undo_performredo()
 {
     // Function to perform an redo if a filled redo slot is present
 
-    unsigned y, row, col, width, height;
+    struct UndoStruct *entry = &undo_entry;
+    unsigned y, row, col, width, height, address;
 
     if (undo_redopossible > 0)
     {
-        if (undonumber < 39)
+        address = (undo_undopossible) ? undo_getnext(undo_current) : undo_tail;
+        undo_readheader(address);
+        row = entry->ystart;
+        col = entry->xstart;
+        width = entry->width;
+        height = entry->height;
+        if (entry->delta == UNDO_CHARSET)
         {
-            undonumber++;
+            undo_charsetswap(entry, address + UNDO_HEADER);
         }
-        else
+        else if (entry->delta == UNDO_MOVE)
         {
-            undonumber = 1;
+            undo_moveapply(entry, address + UNDO_HEADER, 1);
         }
-        row = Undo[undonumber - 1].ystart;
-        col = Undo[undonumber - 1].xstart;
-        width = Undo[undonumber - 1].width;
-        height = Undo[undonumber - 1].height;
-        for (y = 0; y < height; y++)
+        else if (entry->delta == UNDO_RESIZE)
         {
-            bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), Undo[undonumber - 1].address + (width * height * 2) + (y * width), width);
-            bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), Undo[undonumber - 1].address + (width * height * 3) + (y * width), width);
+            undo_resizeapply(entry, address + UNDO_HEADER, 1);
         }
-        vdcwin_cpy_viewport(&canvas);
-        if (showbar)
+        else if (entry->delta)
         {
-            initstatusbar();
+            undo_deltaapply(entry, address + UNDO_HEADER);
         }
-        undoaddress = Undo[undonumber - 1].address;
-        undo_undopossible++;
-        undo_redopossible--;
-        if (undonumber < 39 && Undo[undonumber].redopresent == 0)
+        for (y = 0; y < height && !entry->delta; y++)
         {
-            undo_redopossible = 0;
+            undostore_get(BNK_1_FULL, screenmap_screenaddr(row + y, col, canvas.sourcewidth), entry->redoaddress + (y * width), width);
+            if (!canvasmono)
+            {
+                undostore_get(BNK_1_FULL, screenmap_attraddr(row + y, col, canvas.sourcewidth, canvas.sourceheight), entry->redoaddress + (width * height) + (y * width), width);
+            }
         }
-        if (undonumber == 39 && Undo[0].redopresent == 0)
+        if (entry->delta != UNDO_CHARSET)
         {
-            undo_redopossible = 0;
+            screenmap_dirty(row, col, width, height);
         }
-    }
-    plotcursor();
-}
-
-// Help screens
-void helpscreen_load(char screennumber)
-{
-    char oldmode = vdc_state.mode;
-
-    // Function to show selected help screen
-    // Input: screennumber: 1-Main mode, 2-Character editor, 3-SelectMoveLinebox, 4-Write/colorwrite mode
-
-    hidecursor();
-
-    // Load system charset if needed
-    if (charsetchanged[1] == 1)
-    {
-        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETSYSTEM, 256);
-    }
-
-    // Set background color to black and switch cursor off
-    vdc_bgcolor(VDC_BLACK);
-
-    // Set standard text mode if needed
-    if (oldmode)
-    {
-        vdc_set_mode(0);
-    }
-
-    // Load selected help screen
-    sprintf(buffer, "vdcsehsc%u", screennumber);
-
-    if (bnk_load(bootdevice, 1, (char *)WINDOWBASEADDRESS, buffer))
-    {
-        bnk_cpytovdc(vdc_state.base_text, BNK_1_FULL, (char *)WINDOWBASEADDRESS, 4048);
-    }
-    else
-    {
-        menu_messagepopup("Insert application disk to view help.");
-    }
-
-    getch();
-
-    // Restore screen
-    if (oldmode)
-    {
-        vdc_set_mode(oldmode);
-    }
-    vdc_bgcolor(screenbackground);
-    vdcwin_cpy_viewport(&canvas);
-    if (showbar)
-    {
-        initstatusbar();
-    }
-    if (screennumber != 2)
-    {
-        resetcursor();
-    }
-
-    // Restore custom charset if needed
-    if (charsetchanged[1] == 1)
-    {
-        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, 256);
-    }
-}
-
-// Application routines
-
-void loadsyscharset()
-// Load system charset if needed
-{
-    if (charsetchanged[1] == 1)
-    {
-        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETSYSTEM, 256);
-    }
-}
-
-void restorealtcharset()
-// Restore custom charset if needed
-{
-    if (charsetchanged[1] == 1)
-    {
-        bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, 256);
-    }
-}
-
-void plotmove(char direction)
-// Drive cursor move
-// Input: ASCII code of cursor key pressed
-{
-    vdc_printc(screen_col, screen_row, bnk_readb(BNK_1_FULL, screenmap_screenaddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth)), bnk_readb(BNK_1_FULL, screenmap_attraddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth, canvas.sourceheight)));
-
-    switch (direction)
-    {
-    case CH_CURS_LEFT:
-        cursormove(1, 0, 0, 0);
-        break;
-
-    case CH_CURS_RIGHT:
-        cursormove(0, 1, 0, 0);
-        break;
+        undo_redraw(entry);
 
-    case CH_CURS_UP:
-        cursormove(0, 0, 1, 0);
-        break;
-
-    case CH_CURS_DOWN:
-        cursormove(0, 0, 0, 1);
-        break;
-
-    default:
-        break;
+        // The redo image is not needed anymore, a next undo captures a new one
+        entry->redopresent = 0;
+        undo_writeheader(address);
+        undo_current = address;
+        undo_undopossible++;
+        undo_redopossible--;
     }
-
-    plotcursor();
-}
-
-void change_plotcolor(char newval)
-// Change the current color to plot in
-{
-    plotcolor = newval;
-    vdc_textcolor(newval);
     plotcursor();
 }
 
-void updatecanvas()
-// Update the menu with the proper screen setting values
-{
-    sprintf(pulldown_titles[0][0], "Width:   %5u ", canvas.sourcewidth);
-    sprintf(pulldown_titles[0][1], "Height:  %5u ", canvas.sourceheight);
-    sprintf(pulldown_titles[0][2], "Background: %2u ", screenbackground);
-    sprintf(pulldown_titles[0][3], "Screenmode: %2u ", vdc_state.mode);
-    vdcwin_viewport_init(&canvas, BNK_1_FULL, (char *)SCREENMAPBASE, canvas.sourcewidth, canvas.sourceheight, getmaxx() + 1, getmaxy() + 1, 0, 0);
-    screentotal = canvas.sourcewidth * canvas.sourceheight;
-}
 char choosedeviceid(char ypos)
 // Choose device ID dialogue
 {
@@ -1155,7 +3639,7 @@ char checkiffileexists(char *filetocheck, unsigned char id)
 char import_dialogue(char mode, const char *message)
 // Dialogue for import functions. Mode 0 = PRG, mode 2 = C64 SEQ, mode 3 = VDC SEQ
 {
-    unsigned newwidth, newheight, y;
+    unsigned newwidth, newheight;
     unsigned maxsize = MEMORYLIMIT - SCREENMAPBASE;
     char *ptrend;
     char yc = 8;
@@ -1214,47 +3698,43 @@ char import_dialogue(char mode, const char *message)
     newwidth = importvars.xpos + importvars.width;
     newheight = importvars.ypos + importvars.height;
 
-    if (SCREENMAP_STORAGE_BYTES(newwidth, newheight) > maxsize)
+    if (SCREENMAP_CANVAS_BYTES(newwidth, newheight) > maxsize)
     {
         vdc_prints(21, yc, "New size unsupported. Press key.");
         getch();
         vdcwin_win_free();
         return 0;
     }
+    else if ((newwidth > canvas.sourcewidth || newheight > canvas.sourceheight) && screencount > 1)
+    {
+        vdcwin_win_free();
+        menu_messagepopup("Resize needs single screen.");
+        return 0;
+    }
     else
     {
-        // Enlarge canvas width if needed
-        if (newwidth > canvas.sourcewidth)
+        // Enlarge the canvas if needed, undoable as a resize with the undo log in VDC memory
+        if (newwidth > canvas.sourcewidth || newheight > canvas.sourceheight)
         {
-            for (y = 0; y < canvas.sourceheight; y++)
+            if (newwidth < canvas.sourcewidth)
             {
-                bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
-                bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, newwidth, canvas.sourceheight), vdc_state.swap_text, canvas.sourcewidth);
-                bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth, canvas.sourceheight), VDC_WHITE, newwidth - canvas.sourcewidth);
+                newwidth = canvas.sourcewidth;
             }
-            for (y = 0; y < canvas.sourceheight; y++)
+            if (newheight < canvas.sourceheight)
             {
-                bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth), canvas.sourcewidth);
-                bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, 0, newwidth), vdc_state.swap_text, canvas.sourcewidth);
-                bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth), CH_SPACE, newwidth - canvas.sourcewidth);
+                newheight = canvas.sourceheight;
             }
-            canvas.sourcewidth = newwidth;
-            canvas.sourcexoffset = 0;
-            updatecanvas();
-        }
+            if (undoenabled == 1 && !undo_banked)
+            {
+                undo_resize(newwidth, newheight);
+            }
+            canvas_resize(newwidth, newheight);
 
-        // Enlarge canvas height if needed
-        if (newheight > canvas.sourceheight)
-        {
-            for (y = 0; y < canvas.sourceheight; y++)
+            // In Bank 1 the undo area starts after the screen map, which has grown over it
+            if (undoenabled != 1 || undo_banked)
             {
-                bnk_memcpy(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, newheight), BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
+                undo_clear();
             }
-            bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight, 0, canvas.sourcewidth, newheight), VDC_WHITE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
-            bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight, 0, canvas.sourcewidth), CH_SPACE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
-            canvas.sourceheight = newheight;
-            canvas.sourceyoffset = 0;
-            updatecanvas();
         }
 
         // Ask for additional import parameters
@@ -1387,6 +3867,11 @@ void mainmenuloop()
             }
             break;
 
+        case 17:
+            loadoverlay(2);
+            togglemono();
+            break;
+
         case 21:
             loadoverlay(3);
             savescreenmap();
@@ -1407,6 +3892,16 @@ void mainmenuloop()
             loadproject();
             break;
 
+        case 25:
+            loadoverlay(3);
+            screensmenu();
+            break;
+
+        case 26:
+            saveformat = (saveformat == SAVEFORMAT_ROWS) ? SAVEFORMAT_RAW : saveformat + 1;
+            sprintf(pulldown_titles[1][5], "Format:    %s", (saveformat == SAVEFORMAT_RLE) ? "RLE " : (saveformat == SAVEFORMAT_ROWS) ? "Rows" : "Raw ");
+            break;
+
         case 31:
             loadoverlay(3);
             loadcharset(0);
@@ -1428,6 +3923,7 @@ void mainmenuloop()
             break;
 
         case 35:
+            charundo_clear();
             vdc_restore_charsets();
             bnk_memcpy(BNK_1_FULL, (char *)CHARSETNORMAL, BNK_CHARROM, (char *)0xd000, 0x1000);
             charsetchanged[0] = 0;
@@ -1472,10 +3968,12 @@ void mainmenuloop()
         case 53:
             undoenabled = (undoenabled == 0) ? 1 : 0;
             sprintf(pulldown_titles[4][2], "Undo: %s", (undoenabled == 1) ? "Enabled  " : "Disabled ");
-            undoaddress = vdc_state.extended; // Reset undo address
-            undonumber = 0;                   // Reset undo number
-            undo_undopossible = 0;            // Reset undo possible flag
-            undo_redopossible = 0;
+            undo_clear();
+            break;
+
+        case 54:
+            loadoverlay(4);
+            undo_statspanel();
             break;
 
         default:
@@ -1526,17 +4024,12 @@ int main(void)
     vdcwin_viewport_init(&canvas, BNK_1_FULL, (char *)SCREENMAPBASE, 80, 25, 80, 25, 0, 0);
     updatecanvas();
 
-    // Detect VDC memory size and set VDC memory config size to 64K if present
-    if (vdc_state.memsize == 64)
-    {
-        strcpy(pulldown_titles[4][2], "Undo: Enabled  "); // Enable undo menuoption
-        pulldown_options[4] = 3;                          // Enable undo menupotion
-        undoenabled = 1;                                  // Set undo enabled flag
-        undoaddress = vdc_state.extended;                 // Reset undo address
-        undonumber = 0;                                   // Reset undo number
-        undo_undopossible = 0;                            // Reset undo possible flag
-        undo_redopossible = 0;                            // Reset redo possible flag
-    }
+    // Enable undo, in VDC memory if 64K is present, else in Bank 1
+    strcpy(pulldown_titles[4][2], "Undo: Enabled  "); // Enable undo menuoption
+    strcpy(pulldown_titles[4][3], "Undo memory    "); // Undo diagnostics menuoption
+    pulldown_options[4] = 4;                          // Enable undo menupotions
+    undoenabled = 1;                                  // Set undo enabled flag
+    undo_clear();                                     // Reset undo address and flags
 
     // Load and show title screen
     printcentered("Load title screen", 29, 24, 22);
@@ -1576,6 +4069,11 @@ int main(void)
     // Clear viewport of titlescreen
     vdc_cls();
 
+    // Lay out the hardware scrolled canvas, the undo area moves above it
+    hwscroll_init();
+    undo_clear();
+    vdcwin_cpy_viewport(&canvas);
+
     // Main program loop
     plotcursor();
     strcpy(programmode, "Main");
@@ -1588,7 +4086,46 @@ int main(void)
         {
             printstatusbar();
         }
-        key = vdcwin_getch();
+
+        // Show edits in the canvas view and the reference pane of the split view
+        canvas_sync();
+        split_sync();
+
+        // Keep the undo memory usage current for the diagnostics
+        undo_stats_update();
+
+        // Load pending rows of a partially loaded screen while waiting for a key
+        do
+        {
+            key = vdcwin_checkch();
+            if (!key && screenload_pending)
+            {
+                screenload_rows(screenload_next + 1);
+            }
+            else if (!key && undoload_pending)
+            {
+                undoload_entry();
+            }
+        } while (!key);
+
+        // Rows down to the one below the view are needed for moving, all rows for other keys
+        if (screenload_pending)
+        {
+            if (screenload_idlekey(key))
+            {
+                screenload_rows(canvas.sourceyoffset + getmaxy() + 2);
+            }
+            else
+            {
+                screenload_finish();
+            }
+        }
+
+        // Only cursor keys leave the undo history loading in the background
+        if (undoload_pending && key != CH_CURS_LEFT && key != CH_CURS_RIGHT && key != CH_CURS_UP && key != CH_CURS_DOWN)
+        {
+            undoload_finish();
+        }
 
         switch (key)
         {
@@ -1597,7 +4134,7 @@ int main(void)
         case CH_CURS_RIGHT:
         case CH_CURS_UP:
         case CH_CURS_DOWN:
-            plotmove(key);
+            plotmove_repeat(key);
             break;
 
         // Increase screencode
@@ -1699,7 +4236,7 @@ int main(void)
         // Grab underlying character and attributes
         case 'g':
             plotscreencode = bnk_readb(BNK_1_FULL, screenmap_screenaddr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, canvas.sourcewidth));
-            newval = bnk_readb(BNK_1_FULL, screenmap_attraddr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight));
+            newval = screenmap_readattr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
             if (newval > 128)
             {
                 plotaltchar = 1;
@@ -1765,6 +4302,42 @@ int main(void)
             movemode();
             break;
 
+        // Overview of the whole canvas
+        case 'o':
+            loadoverlay(5);
+            minimap();
+            break;
+
+        // Zoomed out view
+        case 'v':
+            loadoverlay(5);
+            zoom();
+            break;
+
+        // Split view with a reference pane
+        case 'd':
+            loadoverlay(4);
+            split_toggle();
+            break;
+
+        // Exchange the split view panes
+        case 'f':
+            if (splitview)
+            {
+                loadoverlay(4);
+                split_flip();
+            }
+            break;
+
+        // Scroll the reference pane
+        case 'j':
+            if (splitview)
+            {
+                loadoverlay(4);
+                split_scroll();
+            }
+            break;
+
         // Select mode
         case 's':
             loadoverlay(2);
@@ -1773,6 +4346,7 @@ int main(void)
 
         // Undo
         case 'z':
+            undo_group_close();
             if (undoenabled == 1 && undo_undopossible > 0)
             {
                 undo_performundo();
@@ -1781,12 +4355,29 @@ int main(void)
 
         // Redo
         case 'y':
+            undo_group_close();
             if (undoenabled == 1 && undo_redopossible > 0)
             {
                 undo_performredo();
             }
             break;
 
+        // Previous screen of the project
+        case '<':
+            if (screencurrent > 0)
+            {
+                screens_switch(screencurrent - 1);
+            }
+            break;
+
+        // Next screen of the project
+        case '>':
+            if (screencurrent < screencount - 1)
+            {
+                screens_switch(screencurrent + 1);
+            }
+            break;
+
         // Try
         case 't':
             loadoverlay(2);
@@ -1803,7 +4394,7 @@ int main(void)
         case CH_SPACE:
             if (undoenabled == 1)
             {
-                undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
+                undo_group_cell(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
             }
             screenmapplot(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, plotscreencode, VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
             break;
@@ -1812,24 +4403,20 @@ int main(void)
         case CH_DEL:
             if (undoenabled == 1)
             {
-                undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
+                undo_group_cell(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
             }
             screenmapplot(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, CH_SPACE, VDC_WHITE);
             break;
 
-        // Go to upper left corner
+        // Go to upper left or lower right corner, page or edge jumps
         case CH_HOME:
-            screen_row = 0;
-            screen_col = 0;
-            canvas.sourceyoffset = 0;
-            canvas.sourcexoffset = 0;
-            vdcwin_cpy_viewport(&canvas);
-            if (showbar)
-            {
-                initstatusbar();
-            }
-            vdcwin_cursor_move(&canvas.view, screen_col, screen_row);
-            plotcursor();
+        case CH_CLEAR:
+        case CH_F2:
+        case CH_F3:
+        case CH_F4:
+        case CH_F5:
+        case CH_F7:
+            canvas_navigate(key);
             break;
 
         // Go to menu
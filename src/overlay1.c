@@ -140,7 +140,7 @@ void writemode()
         case CH_DEL:
             if (undoenabled == 1)
             {
-                undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
+                undo_group_cell(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
             }
             screenmapplot(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, CH_SPACE, VDC_WHITE);
             plotcursor();
@@ -148,6 +148,7 @@ void writemode()
 
         // Perform undo
         case CH_F2:
+            undo_group_close();
             if (undoenabled == 1 && undo_undopossible > 0)
             {
                 undo_performundo();
@@ -156,6 +157,7 @@ void writemode()
 
         // Perform redo
         case CH_F4:
+            undo_group_close();
             if (undoenabled == 1 && undo_redopossible > 0)
             {
                 undo_performredo();
@@ -251,7 +253,7 @@ void writemode()
             {
                 if (undoenabled == 1)
                 {
-                    undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
+                    undo_group_cell(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
                 }
                 if (rvs == 0)
                 {
@@ -268,6 +270,7 @@ void writemode()
             break;
         }
     } while (key != CH_ESC && key != CH_STOP);
+    undo_group_close();
     strcpy(programmode, "Main");
 }
 
@@ -277,6 +280,15 @@ void colorwrite()
 
     char key, attribute, written;
 
+    // Mono canvas has no attributes to write
+    if (canvasmono)
+    {
+        hidecursor();
+        menu_messagepopup("Not available for mono.");
+        resetcursor();
+        return;
+    }
+
     strcpy(programmode, "Colorwrite");
     do
     {
@@ -288,7 +300,7 @@ void colorwrite()
         written = 0;
 
         // Get old attribute value
-        attribute = bnk_readb(BNK_1_FULL, screenmap_attraddr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcewidth, canvas.sourcewidth, canvas.sourceheight));
+        attribute = bnk_readb(BNK_1_FULL, screenmap_attraddr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight));
 
         switch (key)
         {
@@ -309,6 +321,7 @@ void colorwrite()
 
         // Perform undo
         case CH_F2:
+            undo_group_close();
             if (undoenabled == 1 && undo_undopossible > 0)
             {
                 undo_performundo();
@@ -317,6 +330,7 @@ void colorwrite()
 
         // Perform redo
         case CH_F4:
+            undo_group_close();
             if (undoenabled == 1 && undo_redopossible > 0)
             {
                 undo_performredo();
@@ -370,12 +384,14 @@ void colorwrite()
         {
             if (undoenabled == 1)
             {
-                undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
+                undo_group_cell(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset);
             }
             bnk_writeb(BNK_1_FULL, screenmap_attraddr(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight), attribute);
+            screenmap_dirty(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, 1, 1);
             plotmove(CH_CURS_RIGHT);
         }
     } while (key != CH_ESC && key != CH_STOP);
+    undo_group_close();
     strcpy(programmode, "Main");
 }
 
@@ -638,9 +654,13 @@ void resizewidth()
     unsigned maxsize = MEMORYLIMIT - SCREENMAPBASE;
     char areyousure = 0;
     char sizechanged = 0;
-    unsigned y;
     char *ptrend;
 
+    if (!screens_single())
+    {
+        return;
+    }
+
     vdc_state.text_attr = mc_menupopup;
     vdcwin_win_new(VDC_POPUP_BORDER, 20, 5, 40, 12);
 
@@ -655,7 +675,7 @@ void resizewidth()
         newwidth = (unsigned)strtol(buffer, &ptrend, 10);
     }
 
-    if (!newwidth || SCREENMAP_STORAGE_BYTES(newwidth, canvas.sourceheight) > maxsize)
+    if (!newwidth || SCREENMAP_CANVAS_BYTES(newwidth, canvas.sourceheight) > maxsize)
     {
         vdc_prints(21, 11, "New size unsupported. Press key.");
         getch();
@@ -669,37 +689,11 @@ void resizewidth()
             areyousure = menu_pulldown(25, 13, VDC_MENU_YESNO, 0);
             if (areyousure == 1)
             {
-                for (y = 1; y < canvas.sourceheight; y++)
-                {
-                    bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_screenaddr(y, 0, canvas.sourcewidth), newwidth);
-                    bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(y, 0, newwidth), vdc_state.swap_text, newwidth);
-                }
-                for (y = 0; y < canvas.sourceheight; y++)
-                {
-                    bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_attraddr(y, 0, canvas.sourcewidth, canvas.sourceheight), newwidth);
-                    bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(y, 0, newwidth, canvas.sourceheight), vdc_state.swap_text, newwidth);
-                }
-                if (screen_col > newwidth - 1)
-                {
-                    screen_col = newwidth - 1;
-                }
                 sizechanged = 1;
             }
         }
         if (newwidth > canvas.sourcewidth)
         {
-            for (y = 0; y < canvas.sourceheight; y++)
-            {
-                bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
-                bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, newwidth, canvas.sourceheight), vdc_state.swap_text, canvas.sourcewidth);
-                bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth, canvas.sourceheight), VDC_WHITE, newwidth - canvas.sourcewidth);
-            }
-            for (y = 0; y < canvas.sourceheight; y++)
-            {
-                bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth), canvas.sourcewidth);
-                bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, 0, newwidth), vdc_state.swap_text, canvas.sourcewidth);
-                bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight - y - 1, canvas.sourcewidth, newwidth), CH_SPACE, newwidth - canvas.sourcewidth);
-            }
             sizechanged = 1;
         }
     }
@@ -708,10 +702,12 @@ void resizewidth()
 
     if (sizechanged == 1)
     {
-        canvas.sourcewidth = newwidth;
-        canvas.sourcexoffset = 0;
-        updatecanvas();
-        placesignature();
+        // Undoable with the undo log in VDC memory, in Bank 1 the undo area moves with the canvas size
+        if (undoenabled == 1 && !undo_banked)
+        {
+            undo_resize(newwidth, canvas.sourceheight);
+        }
+        canvas_resize(newwidth, canvas.sourceheight);
         vdc_state.text_attr = VDC_WHITE;
         vdc_cls();
         vdcwin_cpy_viewport(&canvas);
@@ -720,8 +716,10 @@ void resizewidth()
         {
             initstatusbar();
         }
-        undo_undopossible = 0;
-        undo_redopossible = 0;
+        if (undoenabled != 1 || undo_banked)
+        {
+            undo_clear();
+        }
     }
 }
 
@@ -733,9 +731,13 @@ void resizeheight()
     unsigned maxsize = MEMORYLIMIT - SCREENMAPBASE;
     char areyousure = 0;
     char sizechanged = 0;
-    unsigned y;
     char *ptrend;
 
+    if (!screens_single())
+    {
+        return;
+    }
+
     vdc_state.text_attr = mc_menupopup;
     vdcwin_win_new(VDC_POPUP_BORDER, 20, 5, 40, 12);
 
@@ -750,7 +752,7 @@ void resizeheight()
         newheight = (unsigned)strtol(buffer, &ptrend, 10);
     }
 
-    if (!newheight || SCREENMAP_STORAGE_BYTES(canvas.sourcewidth, newheight) > maxsize)
+    if (!newheight || SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, newheight) > maxsize)
     {
         vdc_prints(21, 11, "New size unsupported. Press key.");
         getch();
@@ -765,22 +767,11 @@ void resizeheight()
             areyousure = menu_pulldown(25, 13, VDC_MENU_YESNO, 0);
             if (areyousure == 1)
             {
-                bnk_memcpy(BNK_1_FULL, screenmap_attraddr(0, 0, canvas.sourcewidth, newheight), BNK_1_FULL, screenmap_attraddr(0, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth * canvas.sourceheight);
-                if (screen_row > newheight - 1)
-                {
-                    screen_row = newheight - 1;
-                }
                 sizechanged = 1;
             }
         }
         if (newheight > canvas.sourceheight)
         {
-            for (y = 0; y < canvas.sourceheight; y++)
-            {
-                bnk_memcpy(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, newheight), BNK_1_FULL, screenmap_attraddr(canvas.sourceheight - y - 1, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
-            }
-            bnk_memset(BNK_1_FULL, screenmap_attraddr(canvas.sourceheight, 0, canvas.sourcewidth, newheight), VDC_WHITE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
-            bnk_memset(BNK_1_FULL, screenmap_screenaddr(canvas.sourceheight, 0, canvas.sourcewidth), CH_SPACE, (newheight - canvas.sourceheight) * canvas.sourcewidth);
             sizechanged = 1;
         }
     }
@@ -789,10 +780,12 @@ void resizeheight()
 
     if (sizechanged == 1)
     {
-        canvas.sourceheight = newheight;
-        canvas.sourceyoffset = 0;
-        updatecanvas();
-        placesignature();
+        // Undoable with the undo log in VDC memory, in Bank 1 the undo area moves with the canvas size
+        if (undoenabled == 1 && !undo_banked)
+        {
+            undo_resize(canvas.sourcewidth, newheight);
+        }
+        canvas_resize(canvas.sourcewidth, newheight);
         vdc_state.text_attr = VDC_WHITE;
         vdc_cls();
         vdcwin_cpy_viewport(&canvas);
@@ -801,8 +794,10 @@ void resizeheight()
         {
             initstatusbar();
         }
-        undo_undopossible = 0;
-        undo_redopossible = 0;
+        if (undoenabled != 1 || undo_banked)
+        {
+            undo_clear();
+        }
     }
 }
 
@@ -93,15 +93,61 @@ void plotvisible(unsigned char row, unsigned char col, unsigned char setorrestor
     {
         if (setorrestore == 1)
         {
-            vdc_printc(col - canvas.sourcexoffset, row - canvas.sourceyoffset, plotscreencode, VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
+            layers_plotcell(col - canvas.sourcexoffset, row - canvas.sourceyoffset, plotscreencode, canvasmono ? monocolor : VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
         }
         else
         {
-            vdc_printc(col - canvas.sourcexoffset, row - canvas.sourceyoffset, bnk_readb(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth)), bnk_readb(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight)));
+            layers_plotcell(col - canvas.sourcexoffset, row - canvas.sourceyoffset, bnk_readb(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth)), screenmap_readattr(row, col));
         }
     }
 }
 
+void lineandbox_follow()
+{
+    // Set the end of the line or box to the cursor after a page or edge jump and draw its shown part again
+    // The end stays down and right of the start, as with the cursor keys
+
+    unsigned x = screen_col + canvas.sourcexoffset;
+    unsigned y = screen_row + canvas.sourceyoffset;
+    unsigned xoffset = canvas.sourcexoffset;
+    unsigned yoffset = canvas.sourceyoffset;
+    unsigned row, col, lastrow, lastcol;
+
+    if (x < select_startx)
+    {
+        x = select_startx;
+    }
+    if (y < select_starty)
+    {
+        y = select_starty;
+    }
+    canvas_viewto(canvas_offsetfor(x, canvas.sourcexoffset, getmaxx()), canvas_offsetfor(y, canvas.sourceyoffset, getmaxy()), x, y);
+    select_endx = x;
+    select_endy = y;
+
+    // A view that did not move still shows the previous line or box
+    if (canvas.sourcexoffset == xoffset && canvas.sourceyoffset == yoffset)
+    {
+        vdcwin_cpy_viewport(&canvas);
+    }
+
+    // Only the part of the line or box within the view is drawn
+    row = (select_starty > canvas.sourceyoffset) ? select_starty : canvas.sourceyoffset;
+    lastrow = (select_endy < canvas.sourceyoffset + getmaxy()) ? select_endy : canvas.sourceyoffset + getmaxy();
+    lastcol = (select_endx < canvas.sourcexoffset + getmaxx()) ? select_endx : canvas.sourcexoffset + getmaxx();
+    for (; row <= lastrow; row++)
+    {
+        for (col = (select_startx > canvas.sourcexoffset) ? select_startx : canvas.sourcexoffset; col <= lastcol; col++)
+        {
+            plotvisible(row, col, 1);
+        }
+    }
+    if (showbar)
+    {
+        initstatusbar();
+    }
+}
+
 void lineandbox(unsigned char draworselect)
 {
     // Select line or box from upper left corner using cursor keys, ESC for cancel and ENTER for accept
@@ -121,6 +167,10 @@ void lineandbox(unsigned char draworselect)
         strcpy(programmode, "Line/Box");
     }
 
+    // The line or box is drawn on screen only until it is accepted, so the cell under the cursor is read again afterwards
+    undo_screendirty = 1;
+    cursor_cached = 0;
+
     do
     {
         if (showbar)
@@ -174,6 +224,18 @@ void lineandbox(unsigned char draworselect)
             }
             break;
 
+        // Page and edge jumps
+        case CH_HOME:
+        case CH_CLEAR:
+        case CH_F2:
+        case CH_F3:
+        case CH_F4:
+        case CH_F5:
+        case CH_F7:
+            canvas_navigate(key);
+            lineandbox_follow();
+            break;
+
         // Toggle statusbar
         case CH_F6:
             togglestatusbar();
@@ -200,15 +262,20 @@ void lineandbox(unsigned char draworselect)
 
     if (key == CH_ENTER && draworselect == 1)
     {
+        undo_screendirty = 0;
         for (y = select_starty; y < select_endy + 1; y++)
         {
             bnk_memset(BNK_1_FULL, screenmap_screenaddr(y, select_startx, canvas.sourcewidth), plotscreencode, select_width);
-            bnk_memset(BNK_1_FULL, screenmap_attraddr(y, select_startx, canvas.sourcewidth, canvas.sourceheight), VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar), select_width);
+            if (!canvasmono)
+            {
+                bnk_memset(BNK_1_FULL, screenmap_attraddr(y, select_startx, canvas.sourcewidth, canvas.sourceheight), VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar), select_width);
+            }
         }
     }
     else
     {
         vdcwin_cpy_viewport(&canvas);
+        undo_screendirty = 0;
         if (showbar)
         {
             initstatusbar();
@@ -225,21 +292,82 @@ void lineandbox(unsigned char draworselect)
     plotcursor();
 }
 
+void move_track(signed char *shift, signed char step, unsigned char size)
+{
+    // Function to track a move mode shift on one axis for undo
+    // shift: net shift, with the furthest shifts in both directions at offsets 2 and 4
+    // Values stay within the area size, beyond it all cells are pushed off anyway
+
+    if ((step > 0 && shift[0] < size) || (step < 0 && shift[0] > -(signed char)size))
+    {
+        shift[0] += step;
+    }
+    if (shift[0] < shift[2])
+    {
+        shift[2] = shift[0];
+    }
+    if (shift[0] > shift[4])
+    {
+        shift[4] = shift[0];
+    }
+}
+
+void move_clear(unsigned row, unsigned col, unsigned width)
+{
+    // Clear a row part of the screen map
+
+    bnk_memset(BNK_1_FULL, screenmap_screenaddr(row, col, canvas.sourcewidth), CH_SPACE, width);
+    if (!canvasmono)
+    {
+        bnk_memset(BNK_1_FULL, screenmap_attraddr(row, col, canvas.sourcewidth, canvas.sourceheight), CH_SPACE, width);
+    }
+}
+
+void move_clearrow(unsigned row)
+{
+    // Clear the part of a row of the cut selection outside the area it was pasted to
+
+    unsigned destx = screen_col + canvas.sourcexoffset;
+    unsigned desty = screen_row + canvas.sourceyoffset;
+    unsigned end = select_startx + select_width;
+
+    if (row < desty || row >= desty + select_height || destx >= end || destx + select_width <= select_startx)
+    {
+        move_clear(row, select_startx, select_width);
+        return;
+    }
+    if (select_startx < destx)
+    {
+        move_clear(row, select_startx, destx - select_startx);
+    }
+    if (destx + select_width < end)
+    {
+        move_clear(row, destx + select_width, end - destx - select_width);
+    }
+}
+
 void movemode()
 {
     // Function to move the viewport
 
     unsigned char key, y;
     unsigned char moved = 0;
+    unsigned char layered = canvas.compositor ? 1 : 0;
+    unsigned char width = getmaxx() + 1;
+    unsigned char height = getmaxy() + 1;
+    signed char shift[UNDO_MOVE_PARAMS] = {0, 0, 0, 0, 0, 0};
 
     strcpy(programmode, "Move");
 
     vdcwin_cursor_toggle(&canvas.view);
 
-    if (undoenabled == 1)
+    // Move works on the display, so show only the edited screen if layers are shown
+    if (layered)
     {
-        undo_new(0, 0, getmaxx() + 1, getmaxy() + 1);
+        vdcwin_viewport_compositor(&canvas, NULL);
+        vdcwin_cpy_viewport(&canvas);
     }
+
     if (showbar)
     {
         hidestatusbar();
@@ -254,24 +382,28 @@ void movemode()
         case CH_CURS_RIGHT:
             vdcwin_scroll_right(&canvas.view, 1);
             vdc_vchar(0, 0, CH_SPACE, VDC_WHITE, getmaxy() + 1);
+            move_track(shift, 1, width);
             moved = 1;
             break;
 
         case CH_CURS_LEFT:
             vdcwin_scroll_left(&canvas.view, 1);
             vdc_vchar(getmaxx(), 0, CH_SPACE, VDC_WHITE, getmaxy() + 1);
+            move_track(shift, -1, width);
             moved = 1;
             break;
 
         case CH_CURS_UP:
             vdcwin_scroll_up(&canvas.view, 1);
             vdc_hchar(0, getmaxy(), CH_SPACE, VDC_WHITE, getmaxx() + 1);
+            move_track(shift + 1, -1, height);
             moved = 1;
             break;
 
         case CH_CURS_DOWN:
             vdcwin_scroll_down(&canvas.view, 1);
             vdc_hchar(0, 0, CH_SPACE, VDC_WHITE, getmaxx() + 1);
+            move_track(shift + 1, 1, height);
             moved = 1;
             break;
 
@@ -284,14 +416,25 @@ void movemode()
         }
     } while (key != CH_ENTER && key != CH_ESC && key != CH_STOP);
 
+    layers_update();
+
     if (moved == 1)
     {
         if (key == CH_ENTER)
         {
+            // Undo keeps only the shift and the strips pushed off the edges
+            if (undoenabled == 1)
+            {
+                undo_move(canvas.sourceyoffset, canvas.sourcexoffset, width, height, shift);
+            }
+            screenmap_dirty(canvas.sourceyoffset, canvas.sourcexoffset, getmaxx() + 1, getmaxy() + 1);
             for (y = 0; y < (getmaxy()+1); y++)
             {
                 bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(y + canvas.sourceyoffset, canvas.sourcexoffset, canvas.sourcewidth), vdc_state.base_text + multab[y], getmaxx()+1);
-                bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(y + canvas.sourceyoffset, canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight), vdc_state.base_attr + multab[y], getmaxx()+1);
+                if (!canvasmono)
+                {
+                    bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(y + canvas.sourceyoffset, canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight), vdc_state.base_attr + multab[y], getmaxx()+1);
+                }
             }
         }
         vdcwin_cpy_viewport(&canvas);
@@ -302,9 +445,9 @@ void movemode()
     }
     else
     {
-        if (undoenabled == 1)
+        if (layered)
         {
-            undo_escapeundo();
+            vdcwin_cpy_viewport(&canvas);
         }
     }
 
@@ -321,6 +464,7 @@ void selectmode()
     // Function to select a screen area to delete, cut, copy or paint
 
     unsigned char key, movekey, x, y, ycount;
+    unsigned destx, desty;
 
     strcpy(programmode, "Select");
 
@@ -393,6 +537,17 @@ void selectmode()
                     plotmove(movekey);
                     break;
 
+                // Page and edge jumps
+                case CH_HOME:
+                case CH_CLEAR:
+                case CH_F2:
+                case CH_F3:
+                case CH_F4:
+                case CH_F5:
+                case CH_F7:
+                    canvas_navigate(movekey);
+                    break;
+
                 case CH_F8:
                     helpscreen_load(3);
                     break;
@@ -413,30 +568,39 @@ void selectmode()
                     return;
                 }
 
-                if (key == 'c')
+                // The selection entry is replaced: copy only changes the destination, cut gets one entry
+                // over source and destination, captured before either changes
+                undo_escapeundo();
+                desty = screen_row + canvas.sourceyoffset;
+                destx = screen_col + canvas.sourcexoffset;
+                if (key == 'x')
+                {
+                    undo_new((desty < select_starty) ? desty : select_starty, (destx < select_startx) ? destx : select_startx,
+                             ((destx > select_startx) ? destx - select_startx : select_startx - destx) + select_width,
+                             ((desty > select_starty) ? desty - select_starty : select_starty - desty) + select_height);
+                }
+                else
                 {
-                    undo_escapeundo();
+                    undo_new(desty, destx, select_width, select_height);
                 }
-                undo_new(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, select_width, select_height);
                 for (ycount = 0; ycount < select_height; ycount++)
                 {
                     y = (screen_row + canvas.sourceyoffset >= select_starty) ? select_height - ycount - 1 : ycount;
 
-                    // Text
-                    bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_screenaddr(select_starty + y, select_startx, canvas.sourcewidth), select_width);
-                    if (key == 'x')
+                    screenmap_rowmove(screenmap_screenaddr(screen_row + canvas.sourceyoffset + y, screen_col + canvas.sourcexoffset, canvas.sourcewidth), screenmap_screenaddr(select_starty + y, select_startx, canvas.sourcewidth), select_width);
+                    if (!canvasmono)
                     {
-                        bnk_memset(BNK_1_FULL, screenmap_screenaddr(select_starty + y, select_startx, canvas.sourcewidth), CH_SPACE, select_width);
+                        screenmap_rowmove(screenmap_attraddr(screen_row + canvas.sourceyoffset + y, screen_col + canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight), screenmap_attraddr(select_starty + y, select_startx, canvas.sourcewidth, canvas.sourceheight), select_width);
                     }
-                    bnk_cpyfromvdc(BNK_1_FULL, screenmap_screenaddr(screen_row + canvas.sourceyoffset + y, screen_col + canvas.sourcexoffset, canvas.sourcewidth), vdc_state.swap_text, select_width);
+                }
 
-                    // Attributes
-                    bnk_cpytovdc(vdc_state.swap_text, BNK_1_FULL, screenmap_attraddr(select_starty + y, select_startx, canvas.sourcewidth, canvas.sourceheight), select_width);
-                    if (key == 'x')
+                // Cut clears the cells of the selection that the pasted copy did not cover
+                if (key == 'x')
+                {
+                    for (y = 0; y < select_height; y++)
                     {
-                        bnk_memset(BNK_1_FULL, screenmap_attraddr(select_starty + y, select_startx, canvas.sourcewidth, canvas.sourceheight), CH_SPACE, select_width);
+                        move_clearrow(select_starty + y);
                     }
-                    bnk_cpyfromvdc(BNK_1_FULL, screenmap_attraddr(screen_row + canvas.sourceyoffset + y, screen_col + canvas.sourcexoffset, canvas.sourcewidth, canvas.sourceheight), vdc_state.swap_text, select_width);
                 }
             }
         }
@@ -446,11 +610,14 @@ void selectmode()
             for (y = 0; y < select_height; y++)
             {
                 bnk_memset(BNK_1_FULL, screenmap_screenaddr(select_starty + y, select_startx, canvas.sourcewidth), CH_SPACE, select_width);
-                bnk_memset(BNK_1_FULL, screenmap_attraddr(select_starty + y, select_startx, canvas.sourcewidth, canvas.sourceheight), CH_SPACE, select_width);
+                if (!canvasmono)
+                {
+                    bnk_memset(BNK_1_FULL, screenmap_attraddr(select_starty + y, select_startx, canvas.sourcewidth, canvas.sourceheight), CH_SPACE, select_width);
+                }
             }
         }
 
-        if (key == 'a')
+        if (key == 'a' && !canvasmono)
         {
             for (y = 0; y < select_height; y++)
             {
@@ -458,7 +625,7 @@ void selectmode()
             }
         }
 
-        if (key == 'p')
+        if (key == 'p' && !canvasmono)
         {
             for (y = 0; y < select_height; y++)
             {
@@ -493,7 +660,7 @@ void plot_try()
     key = vdcwin_getch();
     if(key==CH_SPACE)
     {
-        if(undoenabled==1) { undo_new(screen_row+canvas.sourceyoffset,screen_col+canvas.sourcexoffset,1,1); }
+        if(undoenabled==1) { undo_group_cell(screen_row+canvas.sourceyoffset,screen_col+canvas.sourcexoffset); }
         screenmapplot(screen_row+canvas.sourceyoffset,screen_col+canvas.sourcexoffset,plotscreencode,VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
     }
     strcpy(programmode,"Main");
@@ -618,6 +785,11 @@ void selectscreenmode()
 {
     char menuchoice;
 
+    if (!screens_single())
+    {
+        return;
+    }
+
     vdc_state.text_attr = mc_menupopup;
     vdcwin_win_new(VDC_POPUP_BORDER, 20, 5, 40, 12);
 
@@ -635,7 +807,13 @@ void selectscreenmode()
     {
         if ((menuchoice - 1) != vdc_state.mode)
         {
-            vdc_set_mode(menuchoice - 1);
+            if (!vdc_set_mode(menuchoice - 1))
+            {
+                menu_messagepopup("Mode needs 64K VDC or mono.");
+                return;
+            }
+            hwscroll_init();
+            undo_clear();
             updatecanvas();
             vdcwin_cpy_viewport(&canvas);
             menu_placebar(0);
@@ -647,6 +825,59 @@ void selectscreenmode()
     }
 }
 
+void togglemono()
+// Toggle the canvas between full colour and mono (screencodes only, one global colour)
+{
+    unsigned long maxsize = MEMORYLIMIT - SCREENMAPBASE;
+
+    if (!screens_single())
+    {
+        return;
+    }
+
+    if (canvasmono)
+    {
+        // Back to full colour: attribute plane is recreated from the mono colour
+        if (SCREENMAP_STORAGE_BYTES(canvas.sourcewidth, canvas.sourceheight) > maxsize)
+        {
+            menu_messagepopup("Canvas too large for colour.");
+            return;
+        }
+        if (vdc_state.memsize == 16 && vdc_modes[vdc_state.mode].extmem)
+        {
+            menu_messagepopup("Screenmode needs mono.");
+            return;
+        }
+        canvasmono = 0;
+        vdc_state.mono = 0;
+        placesignature();
+        bnk_memset(BNK_1_FULL, screenmap_attraddr(0, 0, canvas.sourcewidth, canvas.sourceheight), monocolor, screentotal);
+    }
+    else
+    {
+        if (menu_areyousure("Colours will be discarded.") != 1)
+        {
+            return;
+        }
+        canvasmono = 1;
+        vdc_state.mono = 1;
+        monocolor = plotcolor;
+    }
+
+    // Undo buffers have the layout of the old mode
+    undo_clear();
+
+    updatecanvas();
+    vdcwin_win_free();
+    vdcwin_cpy_viewport(&canvas);
+    vdcwin_win_new(0, 0, 0, vdc_state.width, 1);
+    menu_placebar(0);
+    if (showbar)
+    {
+        initstatusbar();
+    }
+}
+
 #pragma code(code)
 #pragma data(data)
 #pragma bss(bss)
\ No newline at end of file
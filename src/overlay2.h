@@ -2,12 +2,14 @@
 #define __OVERLAY2_H_
 
 void plotvisible(unsigned char row, unsigned char col, unsigned char setorrestore);
+void lineandbox_follow();
 void lineandbox(unsigned char draworselect);
 void movemode();
 void selectmode();
 void plot_try();
 void changebackgroundcolor();
 void selectscreenmode();
+void togglemono();
 
 #pragma compile("overlay2.c")
 
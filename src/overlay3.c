@@ -87,6 +87,126 @@ BUT WITHOUT ANY WARRANTY. USE THEM AT YOUR OWN RISK!
 #pragma data(dataovl3)
 #pragma bss(bssovl3)
 
+void screenmap_saveprogress(unsigned count)
+// Progress report of the streaming writer
+{
+    sprintf(linebuffer, "Bytes written: %5u", count);
+    vdc_prints(10, 11, linebuffer);
+}
+
+char screenmap_save(char device, const char *fname)
+// Save the Bank 1 screen map streamed to file in the selected save format
+// Returns 1 on success
+{
+    unsigned size = (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight);
+    unsigned row;
+    char old_attr = vdc_state.text_attr;
+    char succes = 0;
+
+    vdc_state.text_attr = mc_menupopup;
+    vdcwin_win_new(VDC_POPUP_BORDER, 8, 8, 30, 6);
+    vdc_prints(10, 9, "Saving.");
+    bnk_stream_progress = screenmap_saveprogress;
+
+    sprintf(linebuffer, "%s,p,w", fname);
+    if (bnk_stream_open(device, linebuffer))
+    {
+        switch (saveformat)
+        {
+        case SAVEFORMAT_RLE:
+            // Header with magic, format and unpacked size
+            bnk_stream_putb(SCREENMAP_RLE_MAGIC0);
+            bnk_stream_putb(SCREENMAP_RLE_MAGIC1);
+            bnk_stream_putb(SCREENMAP_RLE_FORMAT);
+            bnk_stream_putb(size & 0xff);
+            bnk_stream_putb(size >> 8);
+            bnk_stream_rle(BNK_1_FULL, (char *)SCREENMAPBASE, size);
+            break;
+
+        case SAVEFORMAT_ROWS:
+            // Header with magic, format, width, height and planes, then per row the screencodes and attributes
+            bnk_stream_putb(SCREENMAP_RLE_MAGIC0);
+            bnk_stream_putb(SCREENMAP_RLE_MAGIC1);
+            bnk_stream_putb(SCREENMAP_ROWS_FORMAT);
+            bnk_stream_putb(canvas.sourcewidth & 0xff);
+            bnk_stream_putb(canvas.sourcewidth >> 8);
+            bnk_stream_putb(canvas.sourceheight & 0xff);
+            bnk_stream_putb(canvas.sourceheight >> 8);
+            bnk_stream_putb((char)SCREENMAP_PLANES);
+            for (row = 0; row < canvas.sourceheight; row++)
+            {
+                bnk_stream_write(BNK_1_FULL, screenmap_screenaddr(row, 0, canvas.sourcewidth), canvas.sourcewidth);
+                if (!canvasmono)
+                {
+                    bnk_stream_write(BNK_1_FULL, screenmap_attraddr(row, 0, canvas.sourcewidth, canvas.sourceheight), canvas.sourcewidth);
+                }
+            }
+            break;
+
+        default:
+            // Legacy layout with load address, same as bnk_save
+            bnk_stream_putb(SCREENMAPBASE & 0xff);
+            bnk_stream_putb(SCREENMAPBASE >> 8);
+            bnk_stream_write(BNK_1_FULL, (char *)SCREENMAPBASE, size);
+            break;
+        }
+        succes = bnk_stream_close();
+    }
+
+    bnk_stream_progress = NULL;
+    vdcwin_win_free();
+    vdc_state.text_attr = old_attr;
+    return succes;
+}
+
+char screenmap_load(char device, const char *fname, unsigned width, unsigned height, char partial)
+// Load a screen map file in the Bank 1 screen map, legacy layout, run length encoded or row format
+// Input: width, height: canvas size the rows are laid out for, with the present mono setting
+//        partial: for row format only load the rows of the view, the rest loads in the background
+// Returns 1 on success, compressed and row format files of another size or number of planes are refused
+{
+    char header[SCREENMAP_ROWS_HEADER];
+    unsigned size;
+    char succes;
+
+    // Read the header to detect a compressed or row format file
+    sprintf(linebuffer, "%s,p,r", fname);
+    krnio_setbnk(0, 0);
+    krnio_setnam(linebuffer);
+    if (!krnio_open(BNK_STREAM_FNUM, device, 2))
+    {
+        return 0;
+    }
+    if (krnio_read(BNK_STREAM_FNUM, header, SCREENMAP_RLE_HEADER) == SCREENMAP_RLE_HEADER && header[0] == SCREENMAP_RLE_MAGIC0 && header[1] == SCREENMAP_RLE_MAGIC1)
+    {
+        size = (unsigned char)header[3] | ((unsigned)header[4] << 8);
+        succes = 0;
+        if (header[2] == SCREENMAP_RLE_FORMAT && size == (unsigned)(SCREENMAP_DATA_BYTES(width, height) * SCREENMAP_PLANES + SCREENMAP_SIGNATURE_BYTES))
+        {
+            succes = (bnk_io_read_rle(BNK_STREAM_FNUM, BNK_1_FULL, (char *)SCREENMAPBASE, size) == size);
+        }
+        else if (header[2] == SCREENMAP_ROWS_FORMAT && krnio_read(BNK_STREAM_FNUM, header + SCREENMAP_RLE_HEADER, SCREENMAP_ROWS_HEADER - SCREENMAP_RLE_HEADER) == SCREENMAP_ROWS_HEADER - SCREENMAP_RLE_HEADER)
+        {
+            // Row format: keep the file open for loading the remaining rows later
+            screenload_width = size;
+            screenload_height = (unsigned char)header[5] | ((unsigned)header[6] << 8);
+            screenload_planes = header[7];
+            if (screenload_width == width && screenload_height == height && screenload_planes == (char)SCREENMAP_PLANES)
+            {
+                screenload_next = 0;
+                screenload_pending = 1;
+                return screenload_rows(partial ? getmaxy() + 1 : screenload_height);
+            }
+        }
+        krnio_close(BNK_STREAM_FNUM);
+        return succes;
+    }
+    krnio_close(BNK_STREAM_FNUM);
+
+    // Legacy layout
+    return bnk_load(device, 1, (char *)SCREENMAPBASE, fname);
+}
+
 void loadscreenmap()
 // Function to load screenmap
 {
@@ -123,17 +243,22 @@ void loadscreenmap()
     textInput(21, 11, buffer, 3);
     newheight = (unsigned)strtol(buffer, &ptrend, 10);
 
-    if (SCREENMAP_STORAGE_BYTES(newwidth, newheight) > maxsize)
+    if (SCREENMAP_CANVAS_BYTES(newwidth, newheight) > maxsize)
     {
         vdc_prints(21, 12, "New size unsupported. Press key.");
         getch();
         vdcwin_win_free();
     }
+    else if ((newwidth != canvas.sourcewidth || newheight != canvas.sourceheight) && screencount > 1)
+    {
+        vdcwin_win_free();
+        menu_messagepopup("Resize needs single screen.");
+    }
     else
     {
         vdcwin_win_free();
 
-        if (bnk_load(targetdevice, 1, (char *)SCREENMAPBASE, filename))
+        if (screenmap_load(targetdevice, filename, newwidth, newheight, 1))
         {
             vdcwin_win_free();
             canvas.sourcewidth = newwidth;
@@ -148,8 +273,7 @@ void loadscreenmap()
             {
                 initstatusbar();
             }
-            undo_undopossible = 0;
-            undo_redopossible = 0;
+            undo_clear();
             // TEST_HOOK: loadscreenmap_complete — screen map populated at SCREENMAPBASE (Bank 1)
 #ifdef TESTMODE
             breakpoint();
@@ -162,6 +286,7 @@ void savescreenmap()
 // Function to save screenmap
 {
     char overwrite;
+    char flattened;
     unsigned escapeflag;
 
     escapeflag = chooseidandfilename("Save screen", 15);
@@ -184,10 +309,16 @@ void savescreenmap()
             cmd(targetdevice, buffer);
         }
 
-        if (!bnk_save(targetdevice, 1, (char *)SCREENMAPBASE, (char *)SCREENMAPBASE + (screentotal * 2) + 48, filename))
+        // Shown layers are saved flattened to a single screen
+        flattened = layers_flatten();
+        if (!screenmap_save(targetdevice, filename))
         {
             menu_fileerrormessage();
         }
+        if (flattened)
+        {
+            screens_fetch(screencurrent);
+        }
         // TEST_HOOK: savescreenmap_complete — screen map saved to disk
 #ifdef TESTMODE
         breakpoint();
@@ -195,17 +326,80 @@ void savescreenmap()
     }
 }
 
+void undo_saveword(unsigned w)
+// Add a little-endian word to the stream
+{
+    bnk_stream_putb(w & 0xff);
+    bnk_stream_putb(w >> 8);
+}
+
+char undo_save(char device)
+// Save the undo history to filename.undo, oldest entry first with its data run length encoded in chunks
+// Redo entries are not saved. Returns 1 on success
+{
+    struct UndoStruct *entry = &undo_entry;
+    unsigned address = undo_tail;
+    unsigned count, i, n;
+    char old_attr = vdc_state.text_attr;
+    char succes = 0;
+
+    undo_group_close();
+    undo_commit();
+
+    vdc_state.text_attr = mc_menupopup;
+    vdcwin_win_new(VDC_POPUP_BORDER, 8, 8, 30, 6);
+    vdc_prints(10, 9, "Saving undo history.");
+    bnk_stream_progress = screenmap_saveprogress;
+
+    sprintf(linebuffer, "%s.undo,p,w", filename);
+    if (bnk_stream_open(device, linebuffer))
+    {
+        bnk_stream_putb(UNDO_FILE_MAGIC0);
+        bnk_stream_putb(UNDO_FILE_MAGIC1);
+        bnk_stream_putb(UNDO_FILE_FORMAT);
+        undo_saveword(canvas.sourcewidth);
+        undo_saveword(canvas.sourceheight);
+        bnk_stream_putb((char)SCREENMAP_PLANES);
+        undo_saveword(undo_undopossible);
+        for (count = 0; count < undo_undopossible; count++)
+        {
+            undo_readheader(address);
+            undo_saveword(entry->ystart);
+            undo_saveword(entry->xstart);
+            undo_saveword(entry->height);
+            undo_saveword(entry->width);
+            bnk_stream_putb(entry->delta);
+            undo_saveword(entry->size);
+            for (i = 0; i < entry->size; i += n)
+            {
+                n = (entry->size - i > UNDO_CHUNK) ? UNDO_CHUNK : entry->size - i;
+                undostore_get(BNK_0_FULL, undo_before, address + UNDO_HEADER + i, n);
+                bnk_stream_rle(BNK_0_FULL, undo_before, n);
+            }
+            address = entry->next;
+        }
+        succes = bnk_stream_close();
+    }
+
+    bnk_stream_progress = NULL;
+    vdcwin_win_free();
+    vdc_state.text_attr = old_attr;
+    return succes;
+}
+
 void saveproject()
 // Function to save project (screen, charsets and metadata)
 {
     char overwrite;
-    char projbuffer[23];
+    char saveundo;
+    char projbuffer[31];
+    char screen;
     int escapeflag;
 
     escapeflag = chooseidandfilename("Save project", 10);
 
     vdcwin_win_free();
-    memset(projbuffer, 0, 23);
+    memset(projbuffer, 0, 31);
 
     if (escapeflag == -1)
     {
@@ -223,12 +417,14 @@ void saveproject()
         {
             sprintf(buffer, "s:%s.proj", filename);
             cmd(targetdevice, buffer);
-            sprintf(buffer, "s:%s.scrn", filename);
+            sprintf(buffer, "s:%s.scr?", filename);
             cmd(targetdevice, buffer);
             sprintf(buffer, "s:%s.chrs", filename);
             cmd(targetdevice, buffer);
             sprintf(buffer, "s:%s.chra", filename);
             cmd(targetdevice, buffer);
+            sprintf(buffer, "s:%s.undo", filename);
+            cmd(targetdevice, buffer);
         }
 
         // Store project data to buffer variable
@@ -255,20 +451,44 @@ void saveproject()
         projbuffer[20] = plotblink;
         projbuffer[21] = plotaltchar;
         projbuffer[22] = vdc_state.mode;
+        projbuffer[23] = canvasmono;
+        projbuffer[24] = monocolor;
+        projbuffer[25] = screencount;
+        projbuffer[26] = screencurrent;
+        projbuffer[27] = layershow | 0x80;
+        projbuffer[28] = layerhidden & 0xff;
+        projbuffer[29] = layerhidden >> 8;
+        projbuffer[30] = layertransparent;
 
         // Store project file
         sprintf(buffer, "%s.proj", filename);
 
-        if (!bnk_save(targetdevice, 0, projbuffer, projbuffer + 23, buffer))
+        if (!bnk_save(targetdevice, 0, projbuffer, projbuffer + 31, buffer))
         {
             menu_fileerrormessage();
         }
 
-        // Store screen data
-        sprintf(buffer, "%s.scrn", filename);
-        if (!bnk_save(targetdevice, 1, (char *)SCREENMAPBASE, (char *)SCREENMAPBASE + (screentotal * 2) + 48, buffer))
+        // Store screen data, other screens are fetched from the VDC cache via the Bank 1 screen map
+        if (screencount > 1)
         {
-            menu_fileerrormessage();
+            screens_store();
+        }
+        for (screen = 0; screen < screencount; screen++)
+        {
+            if (screencount > 1)
+            {
+                screens_fetch(screen);
+            }
+            screens_filename(screen);
+            if (!screenmap_save(targetdevice, buffer))
+            {
+                menu_fileerrormessage();
+                break;
+            }
+        }
+        if (screencount > 1)
+        {
+            screens_fetch(screencurrent);
         }
 
         // Store standard charset
@@ -290,6 +510,20 @@ void saveproject()
                 menu_fileerrormessage();
             }
         }
+
+        // Store undo history if wanted
+        if (undoenabled == 1 && undo_undopossible > 0)
+        {
+            vdc_state.text_attr = mc_menupopup;
+            vdcwin_win_new(VDC_POPUP_BORDER, 20, 5, 40, 7);
+            vdc_prints(21, 6, "Save undo history?");
+            saveundo = menu_pulldown(25, 8, VDC_MENU_YESNO, 0);
+            vdcwin_win_free();
+            if (saveundo == 1 && !undo_save(targetdevice))
+            {
+                menu_fileerrormessage();
+            }
+        }
         // TEST_HOOK: saveproject_complete — project files (.proj/.scrn/.chrs/.chra) written to disk
 #ifdef TESTMODE
         breakpoint();
@@ -300,7 +534,7 @@ void saveproject()
 void loadproject()
 // Function to load project (screen, charsets and metadata)
 {
-    char projbuffer[23];
+    char projbuffer[31];
     char oldcharchanged[2];
     unsigned new_screen_col;
     unsigned new_screen_row;
@@ -308,7 +542,10 @@ void loadproject()
     unsigned new_sourceheight;
     unsigned new_screentotal;
     unsigned new_mode;
-    memset(projbuffer, 0, 23);
+    char new_mono;
+    char new_screencount;
+    char screen;
+    memset(projbuffer, 0, 31);
 
     {
         char _fp;
@@ -337,13 +574,14 @@ void loadproject()
     new_sourcewidth = ((unsigned char)projbuffer[4] << 8) | (unsigned char)projbuffer[5];
     new_sourceheight = ((unsigned char)projbuffer[6] << 8) | (unsigned char)projbuffer[7];
     new_mode = (unsigned char)projbuffer[22];
+    new_mono = projbuffer[23] ? 1 : 0;
     new_screentotal = SCREENMAP_DATA_BYTES(new_sourcewidth, new_sourceheight);
 
     if (!new_sourcewidth ||
         !new_sourceheight ||
         new_screen_col >= new_sourcewidth ||
         new_screen_row >= new_sourceheight ||
-        SCREENMAP_STORAGE_BYTES(new_sourcewidth, new_sourceheight) > (unsigned long)(MEMORYLIMIT - SCREENMAPBASE) ||
+        (new_mono ? SCREENMAP_MONO_STORAGE_BYTES(new_sourcewidth, new_sourceheight) : SCREENMAP_STORAGE_BYTES(new_sourcewidth, new_sourceheight)) > (unsigned long)(MEMORYLIMIT - SCREENMAPBASE) ||
         new_mode > VDC_TEXT_80x60_NTSC)
     {
         menu_messagepopup("Invalid project file.");
@@ -372,28 +610,39 @@ void loadproject()
     plotunderline = (unsigned char)projbuffer[19];
     plotblink = (unsigned char)projbuffer[20];
     plotaltchar = (unsigned char)projbuffer[21];
-    if (new_mode != vdc_state.mode)
+    if (new_mode != vdc_state.mode || new_mono != canvasmono)
     {
-        vdc_set_mode(new_mode);
+        // A mode this VDC can not show keeps the present mode, or 80x25 if the mono setting rules that out too
+        vdc_state.mono = new_mono;
+        if (!vdc_set_mode(new_mode))
+        {
+            menu_messagepopup("Mode needs 64K VDC or mono.");
+            if (!vdc_set_mode(vdc_state.mode))
+            {
+                vdc_set_mode(VDC_TEXT_80x25_PAL);
+            }
+        }
+        hwscroll_init();
     }
-    updatecanvas();
+    canvasmono = new_mono;
+    monocolor = new_mono ? (unsigned char)projbuffer[24] : VDC_WHITE;
+    screencount = 1;
+    screencurrent = 0;
 
-    // Load screen
-    sprintf(buffer, "%s.scrn", filename);
-    if (bnk_load(targetdevice, 1, (char *)SCREENMAPBASE, buffer))
+    // Layer settings, bit 7 of byte 27 marks files having them
+    if (projbuffer[27] & 0x80)
     {
-        vdcwin_win_free();
-        placesignature();
-        vdcwin_cpy_viewport(&canvas);
-        vdcwin_win_new(0, 0, 0, vdc_state.width, 1);
-        menu_placebar(0);
-        if (showbar)
-        {
-            initstatusbar();
-        }
-        undo_undopossible = 0;
-        undo_redopossible = 0;
+        layershow = projbuffer[27] & 0x01;
+        layerhidden = (unsigned char)projbuffer[28] | ((unsigned)projbuffer[29] << 8);
+        layertransparent = projbuffer[30];
+    }
+    else
+    {
+        layershow = 0;
+        layerhidden = 0;
+        layertransparent = CH_SPACE;
     }
+    updatecanvas();
 
     // Restore charsets if needed if new project has no charsets
     if ((!charsetchanged[0] && oldcharchanged[0]) || (!charsetchanged[1] && oldcharchanged[1]))
@@ -404,6 +653,8 @@ void loadproject()
         charsetchanged[1] = 1;
     }
 
+    charundo_clear();
+
     // Load standard charset
     if (charsetchanged[0] == 1)
     {
@@ -419,12 +670,174 @@ void loadproject()
         bnk_load(targetdevice, 1, (char *)CHARSETALTERNATE, buffer);
         bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, 256);
     }
+
+    // Load screens, cache them in VDC memory if more than one
+    // A single screen in row format shows after loading the visible rows, the rest loads in the background
+    new_screencount = projbuffer[25] ? (unsigned char)projbuffer[25] : 1;
+    if (new_screencount > screens_maxcount())
+    {
+        new_screencount = screens_maxcount();
+        menu_messagepopup("Not all screens fit in VDC.");
+    }
+    for (screen = 0; screen < new_screencount; screen++)
+    {
+        screens_filename(screen);
+        if (!screenmap_load(targetdevice, buffer, canvas.sourcewidth, canvas.sourceheight, new_screencount == 1))
+        {
+            break;
+        }
+        if (new_screencount > 1)
+        {
+            bnk_cpytovdc(screens_slotaddress(screen), BNK_1_FULL, (char *)SCREENMAPBASE, (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight));
+        }
+    }
+    if (screen)
+    {
+        // A screen that failed to load left its part in the screen map, so fetch a cached one also when only the first is left
+        screencount = screen;
+        if (new_screencount > 1)
+        {
+            screencurrent = ((unsigned char)projbuffer[26] < screencount) ? projbuffer[26] : 0;
+            screens_fetch(screencurrent);
+        }
+        updatecanvas_title();
+        layers_update();
+        vdcwin_win_free();
+        placesignature();
+        vdcwin_cpy_viewport(&canvas);
+        vdcwin_win_new(0, 0, 0, vdc_state.width, 1);
+        menu_placebar(0);
+        if (showbar)
+        {
+            initstatusbar();
+        }
+        undo_clear();
+
+        // A saved undo history loads in the background after the screen
+        undoload_pending = (undoenabled == 1) ? 1 : 0;
+    }
+
     // TEST_HOOK: loadproject_complete — screen map and charsets loaded at SCREENMAPBASE (Bank 1)
 #ifdef TESTMODE
+    undoload_finish();
     breakpoint();
 #endif
 }
 
+void screens_filename(char screen)
+// Compose filename of a screen of the project in buffer: first screen .scrn, others .scr2 to .scr9
+{
+    if (screen)
+    {
+        sprintf(buffer, "%s.scr%u", filename, screen + 1);
+    }
+    else
+    {
+        sprintf(buffer, "%s.scrn", filename);
+    }
+}
+
+void screens_new(char duplicate)
+// Add a new screen after the last screen and switch to it
+// Input: duplicate: empty screen (0) or copy of present screen (1)
+{
+    if (screencount >= screens_maxcount())
+    {
+        menu_messagepopup("No VDC memory for screen.");
+        return;
+    }
+
+    // Store present screen, also if this is the first extra screen
+    screens_store();
+    screencurrent = screencount++;
+    layerhidden &= ~(1U << screencurrent);
+    if (!duplicate)
+    {
+        // With layers shown the new screen starts as a fully transparent layer
+        screenmapfill(layershow ? layertransparent : CH_SPACE, canvasmono ? monocolor : VDC_WHITE);
+    }
+    undo_clear();
+}
+
+void screens_delete()
+// Delete the present screen, later screens move one position down
+{
+    char screen;
+    unsigned size = (unsigned)SCREENMAP_CANVAS_BYTES(canvas.sourcewidth, canvas.sourceheight);
+
+    if (screencount < 2)
+    {
+        menu_messagepopup("Cannot delete last screen.");
+        return;
+    }
+    if (menu_areyousure("Delete present screen.") != 1)
+    {
+        return;
+    }
+
+    // Move cache slots down via the Bank 1 screen map
+    for (screen = screencurrent + 1; screen < screencount; screen++)
+    {
+        screens_fetch(screen);
+        bnk_cpytovdc(screens_slotaddress(screen - 1), BNK_1_FULL, (char *)SCREENMAPBASE, size);
+    }
+    screencount--;
+    layerhidden = (layerhidden & ((1U << screencurrent) - 1)) | ((layerhidden >> 1) & ~((1U << screencurrent) - 1));
+    if (screencurrent >= screencount)
+    {
+        screencurrent = screencount - 1;
+    }
+    screens_fetch(screencurrent);
+    undo_clear();
+}
+
+void screensmenu()
+// Menu to add, duplicate or delete screens of the project and to set the layers
+{
+    char choice = menu_option_select("Screens:", VDC_MENU_SCREENS);
+
+    switch (choice)
+    {
+    case 1:
+        screens_new(0);
+        break;
+
+    case 2:
+        screens_new(1);
+        break;
+
+    case 3:
+        screens_delete();
+        break;
+
+    case 4:
+        layershow = !layershow;
+        break;
+
+    case 5:
+        layerhidden ^= 1U << screencurrent;
+        break;
+
+    case 6:
+        layertransparent = plotscreencode;
+        break;
+
+    default:
+        return;
+    }
+
+    updatecanvas_title();
+    layers_update();
+    vdcwin_win_free();
+    vdcwin_cpy_viewport(&canvas);
+    vdcwin_win_new(0, 0, 0, vdc_state.width, 1);
+    menu_placebar(0);
+    if (showbar)
+    {
+        initstatusbar();
+    }
+}
+
 void loadcharset(char stdoralt)
 // Function to load charset
 // Input: stdoralt: standard charset (0) or alternate charset (1)
@@ -445,6 +858,13 @@ void loadcharset(char stdoralt)
 
     charsetaddress = (stdoralt == 0) ? (char *)CHARSETNORMAL : (char *)CHARSETALTERNATE;
 
+    // Keep the present charset as undo entry, glyph edits do not apply to the new one
+    if (undoenabled == 1)
+    {
+        undo_charset(stdoralt);
+    }
+    charundo_clear();
+
     if (bnk_load(targetdevice, 1, charsetaddress, filename))
     {
         if (stdoralt == 0)
@@ -1,12 +1,19 @@
 #ifndef __OVERLAY3_H_
 #define __OVERLAY3_H_
 
+void screenmap_saveprogress(unsigned count);
+char screenmap_save(char device, const char *fname);
+char screenmap_load(char device, const char *fname, unsigned width, unsigned height, char partial);
 void loadscreenmap();
 void savescreenmap();
 void saveproject();
 void loadproject();
 void loadcharset(char stdoralt);
 void savecharset(char stdoralt);
+void screens_filename(char screen);
+void screens_new(char duplicate);
+void screens_delete();
+void screensmenu();
 
 #pragma compile("overlay3.c")
 
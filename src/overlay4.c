@@ -147,6 +147,73 @@ void showchareditgrid(unsigned screencode, char stdoralt)
     }
 }
 
+void charundo_record(char screencode, char stdoralt, unsigned char *before, unsigned char *after)
+// Function to add a glyph edit to the history as XOR of the bytes before and after the edit
+// A new edit discards the redo chain, if the ring is full the oldest edit is dropped
+{
+    struct CharUndoStruct *entry;
+    char y;
+
+    charundo_redopossible = 0;
+    charundo_newest = (charundo_newest + 1) % CHARUNDO_MAX;
+    if (charundo_undopossible < CHARUNDO_MAX)
+    {
+        charundo_undopossible++;
+    }
+    entry = &charundo[charundo_newest];
+    entry->screencode = screencode;
+    entry->stdoralt = stdoralt;
+    for (y = 0; y < 8; y++)
+    {
+        entry->delta[y] = before[y] ^ after[y];
+    }
+}
+
+struct CharUndoStruct *charundo_apply(char redo)
+// Function to undo or redo a glyph edit by applying its XOR to the glyph in Bank 1 and VDC memory
+// Input: redo flag, undo (0) or redo (1)
+// Returns the entry of the glyph changed, or 0 if there is nothing to undo or redo
+{
+    struct CharUndoStruct *entry;
+    unsigned vdcaddress;
+    char *address;
+    char y, b;
+
+    if (redo)
+    {
+        if (!charundo_redopossible)
+        {
+            return 0;
+        }
+        charundo_newest = (charundo_newest + 1) % CHARUNDO_MAX;
+        entry = &charundo[charundo_newest];
+        charundo_redopossible--;
+        charundo_undopossible++;
+    }
+    else
+    {
+        if (!charundo_undopossible)
+        {
+            return 0;
+        }
+        entry = &charundo[charundo_newest];
+        charundo_newest = (charundo_newest + CHARUNDO_MAX - 1) % CHARUNDO_MAX;
+        charundo_undopossible--;
+        charundo_redopossible++;
+    }
+
+    // Only the 8 bytes of the glyph are uploaded to VDC memory
+    address = (char *)charaddress(entry->screencode, entry->stdoralt, 1);
+    vdcaddress = charaddress(entry->screencode, entry->stdoralt, 0);
+    for (y = 0; y < 8; y++)
+    {
+        b = bnk_readb(BNK_1_FULL, address + y) ^ entry->delta[y];
+        bnk_writeb(BNK_1_FULL, address + y, b);
+        vdc_mem_write_at(vdcaddress + y, b);
+    }
+    return entry;
+}
+
 void chareditor()
 {
     unsigned char x, y, char_altorstd, char_screencode, key;
@@ -154,13 +221,14 @@ void chareditor()
     unsigned char ypos = 0;
     unsigned char char_present[8];
     unsigned char char_copy[8];
-    unsigned char char_undo[8];
+    unsigned char char_before[8];
     unsigned char char_buffer[8];
     unsigned int char_address;
     unsigned char charchanged = 0;
     unsigned char altchanged = 0;
     char bitset;
     char *ptrend;
+    struct CharUndoStruct *undone;
 
     char_altorstd = plotaltchar;
     char_screencode = plotscreencode;
@@ -181,7 +249,6 @@ void chareditor()
     for (y = 0; y < 8; y++)
     {
         char_present[y] = vdc_mem_read_at(char_address + y);
-        char_undo[y] = char_present[y];
     }
 
     hidecursor();
@@ -198,6 +265,7 @@ void chareditor()
         }
         key = vdcwin_getch();
         vdc_printc(xpos+71,ypos+3,CH_SPACE+bitset*128,vdc_state.text_attr);
+        memcpy(char_before, char_present, 8);
 
         switch (key)
         {
@@ -274,15 +342,21 @@ void chareditor()
             showchareditgrid(char_screencode, char_altorstd);
             break;
 
-        // Undo
+        // Undo and redo, switching to the glyph changed
         case 'z':
-            for (y = 0; y < 8; y++)
+        case CH_F2:
+        case CH_F4:
+            undone = charundo_apply(key == CH_F4);
+            if (undone)
             {
-                char_present[y] = char_undo[y];
-                vdc_mem_write_at(char_address + y, char_present[y]);
-                bnk_writeb(BNK_1_FULL, (char*) charaddress(char_screencode, char_altorstd, 1) + y, char_present[y]);
+                if (undone->stdoralt != char_altorstd)
+                {
+                    char_altorstd = undone->stdoralt;
+                    altchanged = 1;
+                }
+                char_screencode = undone->screencode;
+                charchanged = 1;
             }
-            showchareditgrid(char_screencode, char_altorstd);
             break;
 
         // Restore from ROM
@@ -492,18 +566,14 @@ void chareditor()
             break;
         }
 
+        // Add an edit of the present glyph to the history
+        if (memcmp(char_before, char_present, 8))
+        {
+            charundo_record(char_screencode, char_altorstd, char_before, char_present);
+        }
+
         if (charchanged || altchanged)
         {
-            if (charchanged)
-            {
-                charchanged = 0;
-                char_address = charaddress(char_screencode, char_altorstd, 0);
-                for (y = 0; y < 8; y++)
-                {
-                    char_present[y] = vdc_mem_read_at(char_address + y);
-                    char_undo[y] = char_present[y];
-                }
-            }
             if (altchanged)
             {
                 altchanged = 0;
@@ -521,6 +591,17 @@ void chareditor()
                 vdcwin_win_free();
                 showchareditfield(char_altorstd);
             }
+
+            // Read the glyph after a charset switch, as the charset is uploaded to VDC memory first
+            if (charchanged)
+            {
+                charchanged = 0;
+                char_address = charaddress(char_screencode, char_altorstd, 0);
+                for (y = 0; y < 8; y++)
+                {
+                    char_present[y] = vdc_mem_read_at(char_address + y);
+                }
+            }
             showchareditgrid(char_screencode, char_altorstd);
         }
     } while (key != CH_ESC && key != CH_STOP);
@@ -561,6 +642,161 @@ void versioninfo()
     vdcwin_win_free();
 }
 
+void undo_statspanel()
+// Show the undo memory usage
+{
+    undo_stats_update();
+    vdc_state.text_attr = mc_menupopup;
+    vdcwin_win_new(VDC_POPUP_BORDER, 20, 5, 40, 14);
+    vdc_underline(1);
+    vdc_prints(21, 6, "Undo memory");
+    vdc_underline(0);
+    sprintf(buffer, "Memory:         %s", (undo_banked) ? "Bank 1" : "VDC");
+    vdc_prints(21, 8, buffer);
+    sprintf(buffer, "Bytes used:     %5u", undo_stats.used);
+    vdc_prints(21, 9, buffer);
+    sprintf(buffer, "Bytes free:     %5u", undo_stats.free);
+    vdc_prints(21, 10, buffer);
+    sprintf(buffer, "Entries:        %5u", undo_stats.entries);
+    vdc_prints(21, 11, buffer);
+    sprintf(buffer, "Largest entry:  %5u", undo_stats.largest);
+    vdc_prints(21, 12, buffer);
+    sprintf(buffer, "Evicted:        %5u", undo_stats.evictions);
+    vdc_prints(21, 13, buffer);
+    sprintf(buffer, "No room redo:   %5u", undo_stats.redofailed);
+    vdc_prints(21, 14, buffer);
+    vdc_prints(21, 16, "Press a key to continue.");
+    getch();
+    vdcwin_win_free();
+}
+
+void split_toggle()
+// Switch the split view with a reference pane below the edited pane on or off
+{
+    unsigned maxoffset;
+
+    hidecursor();
+    if (!splitview)
+    {
+        splitview = 1;
+        vdcwin_viewport_init(&refview, BNK_1_FULL, (char *)SCREENMAPBASE, canvas.sourcewidth, canvas.sourceheight, getmaxx() + 1, 1, 0, SPLIT_ROWS + 1);
+        vdcwin_viewport_mono(&refview, canvasmono, monocolor);
+        refview.sourcexoffset = canvas.sourcexoffset;
+        refview.sourceyoffset = canvas.sourceyoffset;
+
+        // Keep the cursor on the same canvas position in the shorter edited pane
+        if (screen_row > getmaxy())
+        {
+            canvas.sourceyoffset += screen_row - getmaxy();
+            screen_row = getmaxy();
+        }
+    }
+    else
+    {
+        splitview = 0;
+
+        // The taller view may not pass the bottom of the canvas
+        maxoffset = canvas.sourceheight - getmaxy() - 1;
+        if (canvas.sourceyoffset > maxoffset)
+        {
+            screen_row += canvas.sourceyoffset - maxoffset;
+            canvas.sourceyoffset = maxoffset;
+        }
+        vdc_state.text_attr = VDC_WHITE;
+        vdc_cls();
+    }
+    vdcwin_init(&canvas.view, 0, 0, getmaxx() + 1, getmaxy() + 1);
+    vdcwin_cpy_viewport(&canvas);
+    if (splitview)
+    {
+        split_redraw();
+    }
+    if (showbar)
+    {
+        initstatusbar();
+    }
+    else if (splitview)
+    {
+        hidestatusbar();
+    }
+    resetcursor();
+}
+
+void split_flip()
+// Exchange the areas shown in the edited and the reference pane
+{
+    unsigned xoffset = canvas.sourcexoffset;
+    unsigned yoffset = canvas.sourceyoffset;
+    unsigned maxoffset = canvas.sourceheight - getmaxy() - 1;
+
+    hidecursor();
+    canvas.sourcexoffset = refview.sourcexoffset;
+    canvas.sourceyoffset = (refview.sourceyoffset < maxoffset) ? refview.sourceyoffset : maxoffset;
+    refview.sourcexoffset = xoffset;
+    refview.sourceyoffset = yoffset;
+    refview.compositor = canvas.compositor;
+    vdcwin_cpy_viewport(&canvas);
+    vdcwin_cpy_viewport(&refview);
+    plotcursor();
+}
+
+void split_scroll()
+// Scroll the reference pane with the cursor keys until RETURN, ESC or STOP
+{
+    char key;
+
+    strcpy(programmode, "Reference");
+    if (showbar)
+    {
+        printstatusbar();
+    }
+    refview.compositor = canvas.compositor;
+
+    do
+    {
+        key = getch();
+        switch (key)
+        {
+        case CH_CURS_LEFT:
+            if (refview.sourcexoffset)
+            {
+                vdcwin_viewportscroll(&refview, SCROLL_LEFT);
+            }
+            break;
+
+        case CH_CURS_RIGHT:
+            if (refview.sourcexoffset + refview.view.wx < canvas.sourcewidth)
+            {
+                vdcwin_viewportscroll(&refview, SCROLL_RIGHT);
+            }
+            break;
+
+        case CH_CURS_UP:
+            if (refview.sourceyoffset)
+            {
+                vdcwin_viewportscroll(&refview, SCROLL_UP);
+            }
+            break;
+
+        case CH_CURS_DOWN:
+            if (refview.sourceyoffset + refview.view.wy < canvas.sourceheight)
+            {
+                vdcwin_viewportscroll(&refview, SCROLL_DOWN);
+            }
+            break;
+
+        default:
+            break;
+        }
+    } while (key != CH_ENTER && key != CH_ESC && key != CH_STOP);
+
+    strcpy(programmode, "Main");
+    if (showbar)
+    {
+        printstatusbar();
+    }
+}
+
 #pragma code(code)
 #pragma data(data)
 #pragma bss(bss)
\ No newline at end of file
@@ -3,6 +3,10 @@
 
 void chareditor();
 void versioninfo();
+void undo_statspanel();
+void split_toggle();
+void split_flip();
+void split_scroll();
 
 #pragma compile("overlay4.c")
 
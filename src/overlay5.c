@@ -184,8 +184,8 @@ char importread(char device, const char *filename)
             }
         }
 
-        // Read color data if selected
-        if (importvars.content == 1 || importvars.content == 3)
+        // Read color data if selected, not for mono canvas
+        if ((importvars.content == 1 || importvars.content == 3) && !canvasmono)
         {
             address = screenmap_attraddr(importvars.ypos, importvars.xpos, canvas.sourcewidth, canvas.sourceheight);
             for (line = 0; line < importvars.height; line++)
@@ -212,7 +212,7 @@ char importread(char device, const char *filename)
         yc++;
 
         // Convert VIC to VDC colours if selected
-        if (importvars.convert == 1 || importvars.uppercase == 2)
+        if ((importvars.convert == 1 || importvars.uppercase == 2) && !canvasmono)
         {
 
             for (y = 0; y < importvars.height; y++)
@@ -256,6 +256,7 @@ void import_prg()
         {
             undo_new(importvars.ypos, importvars.xpos, importvars.width, importvars.height);
         }
+        screenmap_dirty(importvars.ypos, importvars.xpos, importvars.width, importvars.height);
 
         // Load imprt data and check for errors
         vdc_clear(20, 8, CH_SPACE, 40, 10);
@@ -288,6 +289,453 @@ void import_prg()
     }
 }
 
+void overview_jump(unsigned x, unsigned y, char redraw)
+// Move the cursor to canvas position x, y with the view centred on it as far as the canvas allows
+// Input: redraw flag to copy the view also if the offsets stay the same, after the screen was overwritten
+{
+    unsigned xoffset = (x > canvas.view.wx / 2) ? x - (canvas.view.wx / 2) : 0;
+    unsigned yoffset = (y > canvas.view.wy / 2) ? y - (canvas.view.wy / 2) : 0;
+
+    if (xoffset > canvas.sourcewidth - getmaxx() - 1)
+    {
+        xoffset = canvas.sourcewidth - getmaxx() - 1;
+    }
+    if (yoffset > canvas.sourceheight - getmaxy() - 1)
+    {
+        yoffset = canvas.sourceheight - getmaxy() - 1;
+    }
+    if (redraw)
+    {
+        canvas.sourcexoffset = xoffset;
+        canvas.sourceyoffset = yoffset;
+        vdcwin_cpy_viewport(&canvas);
+        if (showbar)
+        {
+            initstatusbar();
+        }
+    }
+    canvas_viewto(xoffset, yoffset, x, y);
+}
+
+// Whole canvas overview
+// One pass over the screen map sums up blocks of cells into one overview cell, shown by density of
+// non-space cells and the majority colour of the block. The blocks showing the present view are reversed.
+
+const char minimap_glyphs[4] = {CH_SPACE, 0x2E, 0x66, 0xA0};
+char minimap_chars[MINIMAP_CHUNK];
+char minimap_attrs[MINIMAP_CHUNK];
+unsigned minimap_count[MINIMAP_MAXW];
+char minimap_color[MINIMAP_MAXW];
+char minimap_votes[MINIMAP_MAXW];
+
+void minimap_emit(char mrow, char mw, unsigned bx, unsigned lastw, unsigned rows, char inview)
+// Draw a row of the overview from the block counts and reset them for the next row
+{
+    unsigned total;
+    unsigned count;
+    char bcol, level, attr;
+    char vx0 = canvas.sourcexoffset / bx;
+    char vx1 = (canvas.sourcexoffset + canvas.view.wx - 1) / bx;
+
+    for (bcol = 0; bcol < mw; bcol++)
+    {
+        total = ((bcol == mw - 1) ? lastw : bx) * rows;
+        count = minimap_count[bcol];
+        if (!count)
+        {
+            level = 0;
+            attr = VDC_DGREY;
+        }
+        else
+        {
+            level = (count * 3 < total) ? 1 : ((count * 3 < total * 2) ? 2 : 3);
+            attr = minimap_color[bcol];
+        }
+        if (inview && bcol >= vx0 && bcol <= vx1)
+        {
+            attr += VDC_A_REVERSE;
+        }
+        vdc_printc(MINIMAP_X + bcol, MINIMAP_Y + mrow, minimap_glyphs[level], attr + VDC_A_ALTCHAR);
+        minimap_count[bcol] = 0;
+        minimap_votes[bcol] = 0;
+    }
+}
+
+void minimap()
+// Show an overview of the whole canvas and jump the view to a position chosen on it
+{
+    unsigned bx = (canvas.sourcewidth + vdc_state.width - 3) / (vdc_state.width - 2);
+    unsigned by = (canvas.sourceheight + vdc_state.height - 6) / (vdc_state.height - 5);
+    char mw = (canvas.sourcewidth + bx - 1) / bx;
+    char mh = (canvas.sourceheight + by - 1) / by;
+    unsigned lastw = canvas.sourcewidth - ((mw - 1) * bx);
+    char vy0 = canvas.sourceyoffset / by;
+    char vy1 = (canvas.sourceyoffset + canvas.view.wy - 1) / by;
+    unsigned x, y, chunk, col, within, rows;
+    char bcol, mrow, color, key, cx, cy, savechar, saveattr;
+
+    // The overview needs the whole screen map, so read any rows still pending from the screen file
+    if (screenload_pending && !screenload_rows(canvas.sourceheight))
+    {
+        return;
+    }
+
+    loadsyscharset();
+    vdc_state.text_attr = mc_menupopup;
+    vdcwin_win_new(VDC_POPUP_BORDER, 1, 1, vdc_state.width - 2, vdc_state.height - 3);
+    vdc_underline(1);
+    sprintf(buffer, "Overview %ux%u, %ux%u per cell", canvas.sourcewidth, canvas.sourceheight, bx, by);
+    vdc_prints(1, 1, buffer);
+    vdc_underline(0);
+    vdc_prints(1, vdc_state.height - 3, "Cursor keys: choose, RETURN: jump, ESC: cancel");
+
+    // Sum up the blocks in one pass over the screen map, a row at a time in chunks copied from Bank 1
+    memset(minimap_count, 0, sizeof(minimap_count));
+    memset(minimap_votes, 0, sizeof(minimap_votes));
+    mrow = 0;
+    rows = 0;
+    for (y = 0; y < canvas.sourceheight; y++)
+    {
+        bcol = 0;
+        within = 0;
+        for (x = 0; x < canvas.sourcewidth; x += chunk)
+        {
+            chunk = canvas.sourcewidth - x;
+            if (chunk > MINIMAP_CHUNK)
+            {
+                chunk = MINIMAP_CHUNK;
+            }
+            bnk_memcpy(BNK_0_FULL, minimap_chars, BNK_1_FULL, screenmap_screenaddr(y, x, canvas.sourcewidth), chunk);
+            if (!canvasmono)
+            {
+                bnk_memcpy(BNK_0_FULL, minimap_attrs, BNK_1_FULL, screenmap_attraddr(y, x, canvas.sourcewidth, canvas.sourceheight), chunk);
+            }
+            for (col = 0; col < chunk; col++)
+            {
+                // Non-space cells and reversed spaces count, colour by majority vote
+                if (minimap_chars[col] != CH_SPACE || (!canvasmono && (minimap_attrs[col] & VDC_A_REVERSE)))
+                {
+                    minimap_count[bcol]++;
+                    color = canvasmono ? monocolor : (minimap_attrs[col] & 0x0f);
+                    if (!minimap_votes[bcol])
+                    {
+                        minimap_color[bcol] = color;
+                        minimap_votes[bcol] = 1;
+                    }
+                    else if (minimap_color[bcol] == color)
+                    {
+                        minimap_votes[bcol]++;
+                    }
+                    else
+                    {
+                        minimap_votes[bcol]--;
+                    }
+                }
+                if (++within == bx)
+                {
+                    within = 0;
+                    bcol++;
+                }
+            }
+        }
+        if (++rows == by || y == canvas.sourceheight - 1)
+        {
+            minimap_emit(mrow, mw, bx, lastw, rows, mrow >= vy0 && mrow <= vy1);
+            mrow++;
+            rows = 0;
+        }
+    }
+
+    // Choose a position, starting at the block of the cursor
+    cx = (canvas.sourcexoffset + screen_col) / bx;
+    cy = (canvas.sourceyoffset + screen_row) / by;
+    do
+    {
+        savechar = vdc_mem_read_at(vdc_state.base_text + vdc_coords(MINIMAP_X + cx, MINIMAP_Y + cy));
+        saveattr = vdc_mem_read_at(vdc_state.base_attr + vdc_coords(MINIMAP_X + cx, MINIMAP_Y + cy));
+        vdc_printc(MINIMAP_X + cx, MINIMAP_Y + cy, '+', VDC_WHITE + VDC_A_BLINK + VDC_A_ALTCHAR);
+        key = vdcwin_getch();
+        vdc_printc(MINIMAP_X + cx, MINIMAP_Y + cy, savechar, saveattr);
+
+        switch (key)
+        {
+        case CH_CURS_LEFT:
+            if (cx > 0)
+            {
+                cx--;
+            }
+            break;
+
+        case CH_CURS_RIGHT:
+            if (cx < mw - 1)
+            {
+                cx++;
+            }
+            break;
+
+        case CH_CURS_UP:
+            if (cy > 0)
+            {
+                cy--;
+            }
+            break;
+
+        case CH_CURS_DOWN:
+            if (cy < mh - 1)
+            {
+                cy++;
+            }
+            break;
+
+        default:
+            break;
+        }
+    } while (key != CH_ENTER && key != CH_ESC && key != CH_STOP);
+
+    vdcwin_win_free();
+    restorealtcharset();
+
+    // Jump with the middle of the chosen block in the middle of the view
+    if (key == CH_ENTER)
+    {
+        x = (cx * bx) + (bx / 2);
+        y = (cy * by) + (by / 2);
+        overview_jump((x < canvas.sourcewidth) ? x : canvas.sourcewidth - 1, (y < canvas.sourceheight) ? y : canvas.sourceheight - 1, 0);
+    }
+}
+
+// Zoomed out view
+// Every screen cell shows 2x2 canvas cells as a quarter block glyph. The glyphs are generated in the first ZOOM_GLYPHS
+// screen codes of the alternate charset while the view is shown, one bit per quarter that holds a non-space cell.
+
+char zoom_glyphs[ZOOM_GLYPHS * 8];
+char zoom_chars[MINIMAP_CHUNK];
+char zoom_attrs[MINIMAP_CHUNK];
+char zoom_rowchars[ZOOM_MAXW];
+char zoom_rowattrs[ZOOM_MAXW];
+
+void zoom_draw(unsigned zx, unsigned zy)
+// Draw the zoomed out view with canvas position zx, zy in the upper left corner
+// Two canvas rows at a time are copied from Bank 1 in chunks, composed into a screen row and copied to the VDC
+{
+    unsigned x, y, n, col;
+    char row, sx, i, bit, cells, lower, glyph, color, ch, at;
+
+    for (row = 0; row < vdc_state.height; row++)
+    {
+        y = zy + (row * 2);
+        lower = (y + 1 < canvas.sourceheight);
+        for (sx = 0; sx < vdc_state.width; sx += cells)
+        {
+            cells = vdc_state.width - sx;
+            if (cells > MINIMAP_CHUNK / 2)
+            {
+                cells = MINIMAP_CHUNK / 2;
+            }
+            x = zx + (sx * 2);
+            n = 0;
+            if (y < canvas.sourceheight && x < canvas.sourcewidth)
+            {
+                n = canvas.sourcewidth - x;
+                if (n > MINIMAP_CHUNK)
+                {
+                    n = MINIMAP_CHUNK;
+                }
+                bnk_memcpy(BNK_0_FULL, minimap_chars, BNK_1_FULL, screenmap_screenaddr(y, x, canvas.sourcewidth), n);
+                if (lower)
+                {
+                    bnk_memcpy(BNK_0_FULL, zoom_chars, BNK_1_FULL, screenmap_screenaddr(y + 1, x, canvas.sourcewidth), n);
+                }
+                if (!canvasmono)
+                {
+                    bnk_memcpy(BNK_0_FULL, minimap_attrs, BNK_1_FULL, screenmap_attraddr(y, x, canvas.sourcewidth, canvas.sourceheight), n);
+                    if (lower)
+                    {
+                        bnk_memcpy(BNK_0_FULL, zoom_attrs, BNK_1_FULL, screenmap_attraddr(y + 1, x, canvas.sourcewidth, canvas.sourceheight), n);
+                    }
+                }
+            }
+
+            // Glyph from the four quarters, colour of the first filled quarter
+            for (i = 0; i < cells; i++)
+            {
+                glyph = 0;
+                color = VDC_DGREY;
+                for (bit = 0; bit < 4; bit++)
+                {
+                    col = (i * 2) + (bit & 1);
+                    if (col < n && (bit < 2 || lower))
+                    {
+                        ch = (bit < 2) ? minimap_chars[col] : zoom_chars[col];
+                        at = (bit < 2) ? minimap_attrs[col] : zoom_attrs[col];
+                        if (ch != CH_SPACE || (!canvasmono && (at & VDC_A_REVERSE)))
+                        {
+                            if (!glyph)
+                            {
+                                color = canvasmono ? monocolor : (at & 0x0f);
+                            }
+                            glyph |= 1 << bit;
+                        }
+                    }
+                }
+                zoom_rowchars[sx + i] = glyph;
+                zoom_rowattrs[sx + i] = color + VDC_A_ALTCHAR;
+            }
+        }
+        bnk_cpytovdc(vdc_state.base_text + vdc_coords(0, row), BNK_0_FULL, zoom_rowchars, vdc_state.width);
+        bnk_cpytovdc(vdc_state.base_attr + vdc_coords(0, row), BNK_0_FULL, zoom_rowattrs, vdc_state.width);
+    }
+}
+
+void zoom()
+// Show the canvas zoomed out to 2x2 cells per screen cell and jump the view to a position chosen in it
+{
+    unsigned cx = (canvas.sourcexoffset + screen_col) & 0xfffe;
+    unsigned cy = (canvas.sourceyoffset + screen_row) & 0xfffe;
+    unsigned zwidth = vdc_state.width * 2;
+    unsigned zheight = vdc_state.height * 2;
+    unsigned maxzx = (canvas.sourcewidth > zwidth) ? (canvas.sourcewidth - zwidth + 1) & 0xfffe : 0;
+    unsigned maxzy = (canvas.sourceheight > zheight) ? (canvas.sourceheight - zheight + 1) & 0xfffe : 0;
+    unsigned zx, zy, oldzx, oldzy;
+    unsigned address;
+    char g, i, top, bottom, key, savechar, saveattr;
+
+    // The view needs the whole screen map, so read any rows still pending from the screen file
+    if (screenload_pending && !screenload_rows(canvas.sourceheight))
+    {
+        return;
+    }
+
+    // Generate the quarter block glyphs: bits 0 to 3 for upper left, upper right, lower left and lower right
+    for (g = 0; g < ZOOM_GLYPHS; g++)
+    {
+        top = ((g & 1) ? 0xf0 : 0) | ((g & 2) ? 0x0f : 0);
+        bottom = ((g & 4) ? 0xf0 : 0) | ((g & 8) ? 0x0f : 0);
+        for (i = 0; i < 4; i++)
+        {
+            zoom_glyphs[(g * 8) + i] = top;
+            zoom_glyphs[(g * 8) + 4 + i] = bottom;
+        }
+    }
+    hidecursor();
+    bnk_redef_charset(vdc_state.char_alt, BNK_0_FULL, zoom_glyphs, ZOOM_GLYPHS);
+
+    // The zoomed out view covers the whole screen, so draw it in the plain mode layout instead of the scroll strip
+    hwscroll_exit();
+
+    // Start with the cursor in the middle of the screen
+    zx = (cx > vdc_state.width) ? (cx - vdc_state.width) & 0xfffe : 0;
+    zy = (cy > vdc_state.height) ? (cy - vdc_state.height) & 0xfffe : 0;
+    if (zx > maxzx)
+    {
+        zx = maxzx;
+    }
+    if (zy > maxzy)
+    {
+        zy = maxzy;
+    }
+    zoom_draw(zx, zy);
+
+    do
+    {
+        address = vdc_coords((cx - zx) / 2, (cy - zy) / 2);
+        savechar = vdc_mem_read_at(vdc_state.base_text + address);
+        saveattr = vdc_mem_read_at(vdc_state.base_attr + address);
+        vdc_printc((cx - zx) / 2, (cy - zy) / 2, savechar, (saveattr ^ VDC_A_REVERSE) | VDC_A_BLINK);
+        key = getch();
+        vdc_printc((cx - zx) / 2, (cy - zy) / 2, savechar, saveattr);
+
+        switch (key)
+        {
+        case CH_CURS_LEFT:
+            if (cx > 0)
+            {
+                cx -= 2;
+            }
+            break;
+
+        case CH_CURS_RIGHT:
+            if (cx + 2 < canvas.sourcewidth)
+            {
+                cx += 2;
+            }
+            break;
+
+        case CH_CURS_UP:
+            if (cy > 0)
+            {
+                cy -= 2;
+            }
+            break;
+
+        case CH_CURS_DOWN:
+            if (cy + 2 < canvas.sourceheight)
+            {
+                cy += 2;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        // Scroll the view by ZOOM_STEP canvas cells past the cursor when the cursor leaves it
+        oldzx = zx;
+        oldzy = zy;
+        if (cx < zx)
+        {
+            zx = (cx > ZOOM_STEP) ? cx - ZOOM_STEP : 0;
+        }
+        if (cx >= zx + zwidth)
+        {
+            zx = cx + ZOOM_STEP + 2 - zwidth;
+            if (zx > maxzx)
+            {
+                zx = maxzx;
+            }
+        }
+        if (cy < zy)
+        {
+            zy = (cy > ZOOM_STEP) ? cy - ZOOM_STEP : 0;
+        }
+        if (cy >= zy + zheight)
+        {
+            zy = cy + ZOOM_STEP + 2 - zheight;
+            if (zy > maxzy)
+            {
+                zy = maxzy;
+            }
+        }
+        if (zx != oldzx || zy != oldzy)
+        {
+            zoom_draw(zx, zy);
+        }
+    } while (key != CH_ENTER && key != CH_ESC && key != CH_STOP);
+
+    // Restore the alternate charset and the editor screen
+    bnk_redef_charset(vdc_state.char_alt, BNK_1_FULL, (char *)CHARSETALTERNATE, ZOOM_GLYPHS);
+    vdc_state.text_attr = VDC_WHITE;
+    hwscroll_init();
+    vdc_cls();
+    if (splitview)
+    {
+        split_redraw();
+    }
+    if (key == CH_ENTER)
+    {
+        overview_jump(cx, cy, 1);
+    }
+    else
+    {
+        vdcwin_cpy_viewport(&canvas);
+        if (showbar)
+        {
+            initstatusbar();
+        }
+        plotcursor();
+    }
+}
+
 // FUTURE_TEST_HOOK: main.c main loop top — for cursor/plot tests (add when needed)
 // FUTURE_TEST_HOOK: banking.c after overlay load — for overlay mechanism tests (add when needed)
 // FUTURE_TEST_HOOK: overlay4.c after charset edit — for character editor tests (add when needed)
@@ -2,6 +2,8 @@
 #define __OVERLAY5_H_
 
 void import_prg();
+void minimap();
+void zoom();
 
 #pragma compile("overlay5.c")
 
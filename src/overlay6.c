@@ -179,7 +179,7 @@ void seqimport_move(char left, char right, char up, char down)
             {
                 if (canvas.sourcexoffset > 0)
                 {
-                    vdcwin_viewportscroll(&canvas, SCROLL_LEFT);
+                    canvas_scroll(SCROLL_LEFT);
                 }
             }
             else
@@ -197,7 +197,7 @@ void seqimport_move(char left, char right, char up, char down)
             {
                 if (canvas.sourcexoffset + screen_col < canvas.sourcewidth - 1)
                 {
-                    vdcwin_viewportscroll(&canvas, SCROLL_RIGHT);
+                    canvas_scroll(SCROLL_RIGHT);
                 }
             }
             else
@@ -224,7 +224,7 @@ void seqimport_move(char left, char right, char up, char down)
             {
                 if (canvas.sourceyoffset > 0)
                 {
-                    vdcwin_viewportscroll(&canvas, SCROLL_UP);
+                    canvas_scroll(SCROLL_UP);
                 }
             }
             else
@@ -242,7 +242,7 @@ void seqimport_move(char left, char right, char up, char down)
             {
                 if (canvas.sourceyoffset + screen_row < canvas.sourceheight - 1)
                 {
-                    vdcwin_viewportscroll(&canvas, SCROLL_DOWN);
+                    canvas_scroll(SCROLL_DOWN);
                 }
             }
             else
@@ -287,7 +287,7 @@ static void seqimport_plot_byte(unsigned char screencode)
 {
     plotscreencode = screencode;
     screenmapplot(screen_row + canvas.sourceyoffset, screen_col + canvas.sourcexoffset, plotscreencode, VDC_Attribute(plotcolor, plotblink, plotunderline, plotreverse, plotaltchar));
-    vdc_printc(screen_col, screen_row, bnk_readb(BNK_1_FULL, screenmap_screenaddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth)), bnk_readb(BNK_1_FULL, screenmap_attraddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth, canvas.sourceheight)));
+    layers_plotcell(screen_col, screen_row, bnk_readb(BNK_1_FULL, screenmap_screenaddr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col, canvas.sourcewidth)), screenmap_readattr(canvas.sourceyoffset + screen_row, canvas.sourcexoffset + screen_col));
     seqimport_move(0, 1, 0, 0);
 }
 
@@ -298,7 +298,10 @@ static void seqimport_clear_region(void)
     for (y = 0; y < importvars.height; ++y)
     {
         bnk_memset(BNK_1_FULL, screenmap_screenaddr(importvars.ypos + y, importvars.xpos, canvas.sourcewidth), CH_SPACE, importvars.width);
-        bnk_memset(BNK_1_FULL, screenmap_attraddr(importvars.ypos + y, importvars.xpos, canvas.sourcewidth, canvas.sourceheight), VDC_WHITE, importvars.width);
+        if (!canvasmono)
+        {
+            bnk_memset(BNK_1_FULL, screenmap_attraddr(importvars.ypos + y, importvars.xpos, canvas.sourcewidth, canvas.sourceheight), VDC_WHITE, importvars.width);
+        }
     }
 }
 
@@ -561,6 +564,7 @@ static void import_seq_mode(char seqmode, const char *title)
         {
             undo_new(importvars.ypos, importvars.xpos, importvars.width, importvars.height);
         }
+        screenmap_dirty(importvars.ypos, importvars.xpos, importvars.width, importvars.height);
 
         // Exit pop up window
         vdcwin_win_free();
@@ -859,7 +863,7 @@ static char seq_emit_rowbreak(char reverse)
     return seq_write_byte(reverse ? 0x0d : 0x8d);
 }
 
-static void export_seq_mode(char seqmode)
+static void export_seq_write(char seqmode)
 {
     char error = 0;
     char status = 0;
@@ -911,7 +915,7 @@ static void export_seq_mode(char seqmode)
                     {
                         // Obtain screen code and attribute for coordinate
                         screencode = bnk_readb(BNK_1_FULL, screenmap_screenaddr(y, x, canvas.sourcewidth));
-                        attr = bnk_readb(BNK_1_FULL, screenmap_attraddr(y, x, canvas.sourcewidth, canvas.sourceheight));
+                        attr = screenmap_readattr(y, x);
                         if (seqmode == SEQ_MODE_C64)
                         {
                             seq_normalize_cell(&screencode, &attr);
@@ -970,6 +974,18 @@ static void export_seq_mode(char seqmode)
     vdcwin_win_free();
 }
 
+static void export_seq_mode(char seqmode)
+{
+    // Shown layers are exported flattened to a single screen
+    char flattened = layers_flatten();
+
+    export_seq_write(seqmode);
+    if (flattened)
+    {
+        screens_fetch(screencurrent);
+    }
+}
+
 void import_seq_c64()
 {
     import_seq_mode(SEQ_MODE_C64, "Import C64 SEQ");
@@ -24,14 +24,24 @@ import time
 sys.path.insert(0, os.path.dirname(__file__))
 
 from vice_monitor import ViceMonitor, ViceMonitorError, DEFAULT_PORT
+import vdcse_actions
 
 # ---------------------------------------------------------------------------
 # Test imports — each module exposes one or more test_* functions
 # ---------------------------------------------------------------------------
 from test_startup import test_startup
+from test_screens import test_screens
+from test_screenfile import test_screen_rle, test_screen_rows
+from test_undo import test_undo, test_undo_fill_then_plot, test_undo_cut
 
 ALL_TESTS = [
     test_startup,
+    test_screens,
+    test_screen_rle,
+    test_screen_rows,
+    test_undo,
+    test_undo_fill_then_plot,
+    test_undo_cut,
 ]
 
 
@@ -78,6 +88,10 @@ def run_all(image: str, symbols: str, port: int) -> bool:
     """Launch VICE, run all tests, return True if all passed."""
     proc = launch_vice(image, port)
 
+    # Tests look up break addresses of resident functions in the label file
+    if symbols:
+        vdcse_actions.LABELS = symbols
+
     # Allow VICE time to start the emulator and open the remote monitor socket,
     # but we don't need to wait for vdcse to finish loading — warp mode below
     # handles that.  3 seconds is enough for VICE itself to start.
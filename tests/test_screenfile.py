@@ -0,0 +1,80 @@
+"""
+Screen files: save and load round trips of the streamed save formats.
+
+RLE steps:
+  1. Select the RLE format (File > Format) and plot a pattern.
+  2. Save the screen, clear it and load the file again (the filepicker 'e'
+     key selects the last directory entry, the file just saved).
+  3. Assert the Bank 1 screen map equals the map before saving.
+  4. Clear again and load the file as 80x24: the stored size does not match
+     the canvas, so the file is refused and the map stays cleared.
+
+Rows steps are the same with the Rows format.  Only the rows of the view
+load at once, the test waits until screenload_pending shows the rows below
+the view have loaded in the background before comparing.
+
+Starts and ends in main mode with the Raw format selected.
+"""
+
+import time
+from vice_monitor import ViceMonitor
+from vdcse_actions import (FORMAT_RAW, FORMAT_RLE, FORMAT_ROWS, MAP_HEIGHT,
+                           MAP_WIDTH, clear_screen, load_last_screen,
+                           plot_pattern, read_map, read_var, save_screen,
+                           set_saveformat)
+
+
+def wait_screenload(mon: ViceMonitor, timeout: float = 20.0):
+    """Wait until the rows of a row format file have loaded in the background."""
+    deadline = time.monotonic() + timeout
+    while read_var(mon, "screenload_pending"):
+        assert time.monotonic() < deadline, f"rows still loading after {timeout}s"
+        time.sleep(0.5)
+
+
+def test_screen_rle(mon: ViceMonitor):
+    """An RLE screen file loads back to the same screen map."""
+
+    set_saveformat(mon, FORMAT_RLE)
+    plot_pattern(mon)
+    saved = read_map(mon)
+
+    save_screen(mon, "TESTRLE")
+    clear_screen(mon)
+    cleared = read_map(mon)
+    assert cleared != saved, "clearing the screen did not change the map"
+
+    load_last_screen(mon)
+    assert read_map(mon) == saved, "RLE screen map differs after loading"
+
+    # A file of another canvas size is refused
+    clear_screen(mon)
+    load_last_screen(mon, MAP_WIDTH, MAP_HEIGHT - 1)
+    assert read_map(mon) == cleared, "RLE file was loaded into a canvas of another size"
+
+    set_saveformat(mon, FORMAT_RAW)
+
+
+def test_screen_rows(mon: ViceMonitor):
+    """A row format screen file loads back to the same screen map."""
+
+    set_saveformat(mon, FORMAT_ROWS)
+    plot_pattern(mon)
+    saved = read_map(mon)
+
+    save_screen(mon, "TESTROWS")
+    clear_screen(mon)
+    cleared = read_map(mon)
+    assert cleared != saved, "clearing the screen did not change the map"
+
+    load_last_screen(mon)
+    wait_screenload(mon)
+    assert read_map(mon) == saved, "row format screen map differs after loading"
+
+    # The header size does not match a canvas of another size
+    clear_screen(mon)
+    load_last_screen(mon, MAP_WIDTH, MAP_HEIGHT - 1)
+    wait_screenload(mon)
+    assert read_map(mon) == cleared, "row format file was loaded into a canvas of another size"
+
+    set_saveformat(mon, FORMAT_RAW)
@@ -0,0 +1,72 @@
+"""
+Project screens: add, duplicate, switch and delete screens (File > Screen).
+
+Steps:
+  1. Plot a pattern on the single screen and keep its screen map.
+  2. Add an empty screen: screencount 2, screen 2 is current and blank.
+  3. Plot on screen 2, switch back with '<' and forward with '>': each
+     screen shows its own map again from the VDC screen cache.
+  4. Delete screen 2: screen 1 is current with its map unchanged.
+  5. Duplicate screen 1: screen 2 is a copy, delete it again.
+
+Starts and ends in main mode with a single screen.
+"""
+
+from vice_monitor import ViceMonitor
+from vdcse_actions import (MENU_SCREENS, SCREENS_ADD, SCREENS_DELETE,
+                           SCREENS_DUPLICATE, MAP_WIDTH, MAP_HEIGHT, edit,
+                           menu_action, menu_leave, plot_pattern, read_map,
+                           read_var)
+
+
+def screens_option(mon: ViceMonitor, option: int, *keys: str):
+    """Choose an option of the screens menu and return to main mode."""
+    menu_action(mon, MENU_SCREENS, *(["DOWN"] * (option - 1)), "RETURN", *keys)
+    menu_leave(mon)
+
+
+def assert_screens(mon: ViceMonitor, count: int, current: int):
+    screencount = read_var(mon, "screencount")
+    screencurrent = read_var(mon, "screencurrent")
+    assert screencount == count, f"screencount is {screencount}, expected {count}"
+    assert screencurrent == current, f"screencurrent is {screencurrent}, expected {current}"
+
+
+def test_screens(mon: ViceMonitor):
+    """Screens are added, cached, switched and deleted without losing maps."""
+
+    assert_screens(mon, 1, 0)
+    plot_pattern(mon)
+    first = read_map(mon)
+
+    # Add an empty screen, it becomes the present screen
+    screens_option(mon, SCREENS_ADD)
+    assert_screens(mon, 2, 1)
+    blank = read_map(mon)
+    cells = MAP_WIDTH * MAP_HEIGHT
+    assert blank[:cells] == b"\x20" * cells, "new screen is not empty"
+
+    edit(mon, "SPACE")
+    second = read_map(mon)
+    assert second != blank, "plot on the second screen did not change its map"
+
+    # Switch between the screens via the VDC cache
+    edit(mon, "<")
+    assert_screens(mon, 2, 0)
+    assert read_map(mon) == first, "first screen changed after switching back"
+    edit(mon, ">")
+    assert_screens(mon, 2, 1)
+    assert read_map(mon) == second, "second screen changed after switching back"
+
+    # Delete the second screen, confirm with Yes
+    screens_option(mon, SCREENS_DELETE, "RETURN")
+    assert_screens(mon, 1, 0)
+    assert read_map(mon) == first, "first screen changed after deleting the second"
+
+    # Duplicate the first screen and delete the copy again
+    screens_option(mon, SCREENS_DUPLICATE)
+    assert_screens(mon, 2, 1)
+    assert read_map(mon) == first, "duplicated screen differs from its source"
+    screens_option(mon, SCREENS_DELETE, "RETURN")
+    assert_screens(mon, 1, 0)
+    assert read_map(mon) == first, "first screen changed after deleting the copy"
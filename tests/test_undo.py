@@ -0,0 +1,93 @@
+"""
+Undo and redo of canvas edits in main mode ('z' undo, 'y' redo).
+
+Steps:
+  1. Plot a run of adjacent cells: they form one undo group.
+  2. Jump three rows down and plot one cell: a second group.
+  3. Undo twice and redo twice, asserting the Bank 1 screen map matches the
+     map after each edit step again.
+  4. Fill the screen (Screen > Fill), undo and redo the full canvas entry.
+  5. Fill, plot cells over the fill and undo twice: the plotted cells get
+     their contents from before the fill back, not a mix with the plots.
+  6. Cut a row of plotted cells (select mode 's', 'x') and paste it two rows
+     down: one undo restores both the cleared source and the destination.
+
+Starts and ends in main mode.
+"""
+
+from vice_monitor import ViceMonitor
+from vdcse_actions import (MENU_FILL, clear_screen, edit, menu_action,
+                           menu_leave, plot_pattern, read_map)
+
+
+def test_undo(mon: ViceMonitor):
+    """Grouped cell edits and a full canvas fill undo and redo exactly."""
+
+    clear_screen(mon)
+    before = read_map(mon)
+
+    plot_pattern(mon)
+    grouped = read_map(mon)
+    assert grouped != before, "plotting did not change the map"
+
+    edit(mon, "DOWN", "DOWN", "DOWN", "SPACE")
+    jumped = read_map(mon)
+    assert jumped != grouped, "plot after the cursor jump did not change the map"
+
+    edit(mon, "z")
+    assert read_map(mon) == grouped, "first undo did not restore the map before the jump plot"
+    edit(mon, "z")
+    assert read_map(mon) == before, "second undo did not restore the map before the grouped plots"
+    edit(mon, "y")
+    assert read_map(mon) == grouped, "first redo did not restore the grouped plots"
+    edit(mon, "y")
+    assert read_map(mon) == jumped, "second redo did not restore the jump plot"
+
+    # Full canvas entry
+    menu_action(mon, MENU_FILL)
+    menu_leave(mon)
+    filled = read_map(mon)
+    assert filled != jumped, "fill did not change the map"
+
+    edit(mon, "z")
+    assert read_map(mon) == jumped, "undo of fill did not restore the map"
+    edit(mon, "y")
+    assert read_map(mon) == filled, "redo of fill did not restore the filled map"
+
+
+def test_undo_fill_then_plot(mon: ViceMonitor):
+    """Cells plotted after a fill come back with their pre-fill contents."""
+
+    clear_screen(mon)
+    before = read_map(mon)
+
+    menu_action(mon, MENU_FILL)
+    menu_leave(mon)
+    filled = read_map(mon)
+
+    plot_pattern(mon)
+    assert read_map(mon) != filled, "plotting over the fill did not change the map"
+
+    edit(mon, "z")
+    assert read_map(mon) == filled, "undo of the plots did not restore the filled map"
+    edit(mon, "z")
+    assert read_map(mon) == before, "undo of the fill did not restore the cells plotted afterwards"
+
+
+def test_undo_cut(mon: ViceMonitor):
+    """Undo of a select mode cut brings back the cleared source cells."""
+
+    clear_screen(mon)
+    plot_pattern(mon)
+    edit(mon, "LEFT", "LEFT", "LEFT")
+    before = read_map(mon)
+
+    # Select four cells, cut them and paste two rows down
+    edit(mon, "s", "RIGHT", "RIGHT", "RIGHT", "RETURN", "x", "DOWN", "DOWN", "RETURN")
+    cut = read_map(mon)
+    assert cut != before, "cut and paste did not change the map"
+
+    edit(mon, "z")
+    assert read_map(mon) == before, "undo of the cut did not restore source and destination"
+    edit(mon, "y")
+    assert read_map(mon) == cut, "redo of the cut did not restore the pasted map"
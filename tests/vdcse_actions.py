@@ -0,0 +1,148 @@
+"""
+Editor actions shared by the VDC Screen Editor 2 test modules.
+
+The tests drive vdcse with injected keys like a user would.  To know when an
+action has finished, they break on functions of the resident main program
+and look up their addresses in the Oscar64 .lbl file:
+
+  menu_main    — entered each time the main menu waits for a choice, so a
+                 break here after a menu action means the action completed.
+  canvas_sync  — called at the top of the main editing loop and from
+                 plotcursor(), so a break here means the menu was left.
+
+Overlay functions share their load address, so only resident labels are used.
+
+All tests assume the default 80x25 colour canvas at SCREENMAPBASE ($5800 in
+Bank 1) and leave the program in the main editing loop when they finish.
+"""
+
+import os
+import re
+import time
+
+LABELS = os.environ.get("VICE_LABELS", "build/vdcse_test.lbl")
+
+SCREENMAPBASE = 0x5800
+MAP_WIDTH = 80
+MAP_HEIGHT = 25
+MAP_SIGNATURE = 48
+MAP_BYTES = MAP_WIDTH * MAP_HEIGHT * 2 + MAP_SIGNATURE
+
+# Menu bar and item numbers as returned by menu_main(): 10 * bar + item
+MENU_CLEAR = (1, 5)
+MENU_FILL = (1, 6)
+MENU_SAVESCREEN = (2, 1)
+MENU_LOADSCREEN = (2, 2)
+MENU_SCREENS = (2, 5)
+MENU_FORMAT = (2, 6)
+
+# Options of the screens menu (VDC_MENU_SCREENS)
+SCREENS_ADD = 1
+SCREENS_DUPLICATE = 2
+SCREENS_DELETE = 3
+
+# saveformat values (SAVEFORMAT_* in include/defines.h)
+FORMAT_RAW = 0
+FORMAT_RLE = 1
+FORMAT_ROWS = 2
+
+_label_cache = {}
+
+
+def label_address(name: str) -> int:
+    """Return the address of a symbol from the Oscar64 .lbl file.
+
+    Label lines look like 'al 5510 .mainmenuloop', optionally with a
+    bank prefix ('al C:5510 .mainmenuloop').
+    """
+    if not _label_cache:
+        pattern = re.compile(r"^al\s+(?:\w+:)?([0-9a-fA-F]+)\s+\.?(\S+)")
+        with open(LABELS) as lbl:
+            for line in lbl:
+                m = pattern.match(line.strip())
+                if m:
+                    _label_cache.setdefault(m.group(2), int(m.group(1), 16))
+    assert name in _label_cache, f"label '{name}' not found in {LABELS}"
+    return _label_cache[name]
+
+
+def run_until(mon, label: str, *keys: str, timeout: float = 30.0):
+    """Inject keys and block until the program reaches label, then resume."""
+    bp = mon.set_break(f"${label_address(label):04x}")
+    mon.keybuf_sequence(*keys)
+    mon.wait_for_break(timeout=timeout)
+    mon.delete_break(bp)    # also resumes execution
+    time.sleep(0.2)
+
+
+def read_map(mon) -> bytes:
+    """Read the screen map of the present screen from Bank 1."""
+    data = mon.read_bank1(SCREENMAPBASE, MAP_BYTES)
+    assert len(data) == MAP_BYTES, f"short screen map read: {len(data)} bytes"
+    return data
+
+
+def read_var(mon, name: str) -> int:
+    """Read a char sized global of the main program."""
+    return mon.read_bank0(label_address(name), 1)[0]
+
+
+def menu_action(mon, option, *dialog_keys: str, timeout: float = 30.0):
+    """Open the main menu from main mode, choose option (bar, item) and type
+    the keys for the dialogue that follows.  Returns with the main menu open
+    again after the action has completed."""
+    bar, item = option
+    run_until(mon, "menu_main", "F1")
+    keys = ["RIGHT"] * (bar - 1) + ["RETURN"] + ["DOWN"] * (item - 1) + ["RETURN"]
+    run_until(mon, "menu_main", *keys, *dialog_keys, timeout=timeout)
+
+
+def menu_leave(mon):
+    """Leave the main menu back to main mode."""
+    run_until(mon, "canvas_sync", "STOP")
+
+
+def edit(mon, *keys: str):
+    """Inject main mode keys and give the editor time to process them."""
+    mon.keybuf_sequence(*keys, delay=0.2)
+    time.sleep(0.5)
+
+
+def filename_keys(name: str):
+    """Keys for a filename input: clear the prefilled name, type name, RETURN.
+    Use uppercase ASCII names, they arrive as unshifted PETSCII letters."""
+    return ["DEL"] * 16 + list(name) + ["RETURN"]
+
+
+def set_saveformat(mon, fmt: int):
+    """Cycle the File menu format option until saveformat is fmt."""
+    for _ in range(3):
+        if read_var(mon, "saveformat") == fmt:
+            return
+        menu_action(mon, MENU_FORMAT)
+        menu_leave(mon)
+    assert read_var(mon, "saveformat") == fmt, f"could not select save format {fmt}"
+
+
+def save_screen(mon, name: str):
+    """Save the present screen to the boot drive as name."""
+    menu_action(mon, MENU_SAVESCREEN, "RETURN", *filename_keys(name), timeout=60.0)
+    menu_leave(mon)
+
+
+def load_last_screen(mon, width: int = MAP_WIDTH, height: int = MAP_HEIGHT):
+    """Load the last file of the directory as screen of width x height."""
+    size_keys = ["DEL"] * 3 + list(str(width)) + ["RETURN"] + ["DEL"] * 3 + list(str(height)) + ["RETURN"]
+    menu_action(mon, MENU_LOADSCREEN, "e", "RETURN", *size_keys, timeout=60.0)
+    menu_leave(mon)
+
+
+def plot_pattern(mon):
+    """Plot a short run of different screencodes next to each other."""
+    edit(mon, "SPACE", "RIGHT", "+", "SPACE", "RIGHT", "+", "+", "SPACE", "RIGHT", "-", "SPACE")
+
+
+def clear_screen(mon):
+    """Clear the present screen with the Screen menu."""
+    menu_action(mon, MENU_CLEAR)
+    menu_leave(mon)